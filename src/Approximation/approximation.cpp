@@ -1,75 +1,552 @@
 #include "approximation.h"
 
+#include <algorithm>
+
+#include "../ThreadPool/thread_pool.h"
+
 namespace s21 {
 
+namespace {
+
+// Vandermonde rows handed to QrLeastSquares at a time
+constexpr size_t kQrChunk = 256;
+
+// Weight of point i at time t: its own weight, if any, times
+// 2^((t - latest) / half_life) when a half-life is set
+struct Weighting {
+  const double* weights{nullptr};
+  double latest{0};
+  double rate{0};
+
+  double operator()(size_t i, double t) const {
+    double w = weights ? weights[i] : 1.0;
+    return rate > 0 ? w * std::exp2((t - latest) * rate) : w;
+  }
+};
+
+// Power sums are taken over fixed blocks of points, kSumLanes points at a
+// time in separate lanes, and the partials are added in a fixed pairwise
+// order, so the result does not depend on how many threads took part
+constexpr size_t kSumBlock = 4096;
+constexpr size_t kSumLanes = 8;
+// Blocks below which the pool is not worth waking
+constexpr size_t kParallelBlocks = 16;
+
+// Sums then moments of points [begin, begin + count) into out, weighted
+// in the same pass; lanes is scratch of (sums + moments) * kSumLanes
+void blockSums(const Point* points, size_t begin, size_t count, size_t sums,
+               size_t moments, const Weighting& weight, double* lanes,
+               double* out) {
+  points += begin;
+  std::fill(lanes, lanes + (sums + moments) * kSumLanes, 0.0);
+  double* lane_moments = lanes + sums * kSumLanes;
+  for (size_t first = 0; first < count; first += kSumLanes) {
+    const size_t group = std::min(kSumLanes, count - first);
+    double x[kSumLanes], y[kSumLanes], p[kSumLanes];
+    for (size_t l = 0; l < kSumLanes; ++l) {
+      const bool used = l < group;
+      x[l] = used ? points[first + l].first : 0.0;
+      y[l] = used ? points[first + l].second : 0.0;
+      p[l] = used ? weight(begin + first + l, x[l]) : 0.0;
+    }
+    size_t k = 0;
+    for (; k < moments; ++k) {
+      for (size_t l = 0; l < kSumLanes; ++l) {
+        lanes[k * kSumLanes + l] += p[l];
+        lane_moments[k * kSumLanes + l] += y[l] * p[l];
+        p[l] *= x[l];
+      }
+    }
+    for (; k < sums; ++k) {
+      for (size_t l = 0; l < kSumLanes; ++l) {
+        lanes[k * kSumLanes + l] += p[l];
+        p[l] *= x[l];
+      }
+    }
+  }
+  for (size_t k = 0; k < sums + moments; ++k) {
+    double* lane = lanes + k * kSumLanes;
+    for (size_t width = kSumLanes / 2; width > 0; width /= 2) {
+      for (size_t l = 0; l < width; ++l) lane[l] += lane[l + width];
+    }
+    out[k] = lane[0];
+  }
+}
+
+// Pairwise sum of the partials of blocks [first, first + count)
+void reduceBlocks(double* partials, size_t first, size_t count,
+                  size_t stride) {
+  if (count < 2) return;
+  const size_t half = count / 2;
+  reduceBlocks(partials, first, half, stride);
+  reduceBlocks(partials, first + half, count - half, stride);
+  double* left = partials + first * stride;
+  const double* right = partials + (first + half) * stride;
+  for (size_t k = 0; k < stride; ++k) left[k] += right[k];
+}
+
+// One fused pass over the points for the sums of x^k and y * x^k, block
+// partials computed on the pool for long series
+void powerSums(const std::vector<Point>& points, const int degree,
+               std::vector<double>& sums, std::vector<double>& moments,
+               ThreadPool& pool, const Weighting& weight = Weighting()) {
+  const size_t rows = degree + 1, count = 2 * degree + 1;
+  const size_t stride = rows + count;
+  const size_t blocks = (points.size() + kSumBlock - 1) / kSumBlock;
+  sums.assign(count, 0);
+  moments.assign(rows, 0);
+  if (!blocks) return;
+  std::vector<double> partials(blocks * stride);
+  auto job = [&points, &partials, &weight, count, rows, stride](
+                 size_t begin, size_t end) {
+    std::vector<double> lanes(stride * kSumLanes);
+    for (size_t b = begin; b < end; ++b) {
+      const size_t first = b * kSumBlock;
+      blockSums(points.data(), first,
+                std::min(kSumBlock, points.size() - first), count, rows,
+                weight, lanes.data(), partials.data() + b * stride);
+    }
+  };
+  if (blocks < kParallelBlocks) {
+    job(0, blocks);
+  } else {
+    pool.parallelFor(0, blocks,
+                     std::max<size_t>(1, blocks / (4 * pool.size())), job);
+  }
+  reduceBlocks(partials.data(), 0, blocks, stride);
+  std::copy(partials.begin(), partials.begin() + count, sums.begin());
+  std::copy(partials.begin() + count, partials.begin() + stride,
+            moments.begin());
+}
+
+// Normal equations: slae(i, j) = sum(x^(i + j)), rhs(i) = sum(y * x^i), so
+// only 2 * degree + 1 power sums and degree + 1 moments are distinct
+void normalMatrix(const std::vector<double>& sums, const int degree,
+                  double* slae) {
+  const size_t rows = degree + 1;
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < rows; ++j) {
+      slae[i * rows + j] = sums[i + j];
+    }
+  }
+}
+
+}  //   namespace
+
 void Approximation::initApproximation(const std::vector<Point>& points,
                                       const int degree) {
+  initApproximation(points, {}, degree);
+}
+
+void Approximation::initApproximation(const TimeSeries& data_points,
+                                      const int degree) {
+  initApproximation(data_points, {}, degree);
+}
+
+void Approximation::initApproximation(const std::vector<Point>& points,
+                                      const std::vector<double>& weights,
+                                      const int degree) {
+  setWeights(weights, points.size());
   points_ = points;
   coeff_.clear();
+  begin = 0;
   calculateCoeff(degree);
 }
 
-void Approximation::initApproximation(std::vector<DataPoint>& data_points,
+void Approximation::initApproximation(const TimeSeries& data_points,
+                                      const std::vector<double>& weights,
                                       const int degree) {
+  setWeights(weights, data_points.size());
   points_.clear();
-  begin = std::mktime(&(data_points.front().first));
-  for (auto& it : data_points) {
-    points_.push_back({std::mktime(&it.first) - begin, it.second});
-  }
   coeff_.clear();
+  if (data_points.empty()) return;
+  begin = static_cast<double>(data_points.time.front());
+  points_.reserve(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    double t = static_cast<double>(data_points.time[i]) - begin;
+    points_.push_back({t, data_points.value[i]});
+  }
   calculateCoeff(degree);
 }
 
+void Approximation::setHalfLife(double half_life) {
+  if (!(half_life >= 0)) {
+    throw std::invalid_argument("Error: negative half-life");
+  }
+  half_life_ = half_life;
+}
+
+void Approximation::setWeights(const std::vector<double>& weights,
+                               size_t count) {
+  if (!weights.empty() && weights.size() != count) {
+    throw std::invalid_argument("Error: one weight per point expected");
+  }
+  weights_ = weights;
+}
+
+double Approximation::weight(size_t i) const {
+  double w = weights_.empty() ? 1.0 : weights_[i];
+  if (half_life_ > 0) {
+    w *= std::exp2((points_[i].first - points_.back().first) / half_life_);
+  }
+  return w;
+}
+
 std::vector<double>& Approximation::getCoeff() { return coeff_; }
 
 double Approximation::getValue(double t) {
   if (coeff_.empty()) {
     throw std::domain_error("Error: Polynomial not inited");
   }
-  double result = coeff_[0];
-  for (int i = 1; i < (int)coeff_.size(); ++i) {
-    result += coeff_[i] * pow((t - begin), i);
+  t = (t - begin) * scale_;
+  if (!alpha_.empty()) {
+    return clenshaw(t);
+  }
+  double result = coeff_.back();
+  for (size_t i = coeff_.size() - 1; i-- > 0;) {
+    result = result * t + coeff_[i];
   }
   return result;
 }
 
+void Approximation::evaluate(const double* t, double* out, size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Polynomial not inited");
+  }
+  const size_t degree = coeff_.size() - 1;
+  double x[kEvalBlock], value[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      x[j] = j < block ? (t[first + j] - begin) * scale_ : 0.0;
+      value[j] = coeff_[degree];
+    }
+    if (!alpha_.empty()) {
+      clenshaw(x, value);
+      std::copy(value, value + block, out + first);
+      continue;
+    }
+    for (size_t k = degree; k-- > 0;) {
+      const double c = coeff_[k];
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        value[j] = value[j] * x[j] + c;
+      }
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
 void Approximation::calculateCoeff(const int degree) {
-  if (!points_.empty()) {
+  scale_ = 1.0;
+  alpha_.clear();
+  residuals_.clear();
+  scores_.clear();
+  if (!points_.empty() && method_ == ApproxMethod::kQr) {
+    calculateCoeffQr(degree);
+  } else if (!points_.empty() &&
+             (method_ == ApproxMethod::kOrthogonal || auto_degree_)) {
+    calculateCoeffOrthogonal(degree);
+  } else if (!points_.empty()) {
     calculateMatrixSLAE(degree);
-    Gauss gauss;
-    try {
-      coeff_ = gauss.getResultSLAE(slae_coeff_);
-    } catch (const std::exception& e) {
+    coeff_.resize(degree + 1);
+    if (solveBatch(slae_coeff_.data(), moments_.data(), coeff_.data(),
+                   degree + 1, 1)) {
       coeff_.clear();
-      std::cerr << e.what() << std::endl;
+      std::cerr << "Error: incorrect SLAE matrix" << std::endl;
     }
   }
 }
 
-void Approximation::calculateMatrixSLAE(const int degree) {
-  slae_coeff_.clear();
-  slae_coeff_.resize(degree + 1);  // rows
-  for (auto& it : slae_coeff_) {
-    it.resize(degree + 2);  // cols
+// x = (t - center) * scale maps the points onto [-1, 1]
+double Approximation::getDerivative(double t, int order) {
+  double out;
+  evaluateDerivative(&t, &out, 1, order);
+  return out;
+}
+
+// Horner over the derivative coefficients k * c(k) or k * (k - 1) * c(k),
+// times scale^order for the chain rule
+void Approximation::evaluateDerivative(const double* t, double* out,
+                                       size_t count, int order) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Polynomial not inited");
+  }
+  if (order != 1 && order != 2) {
+    throw std::invalid_argument("Error: derivative order must be 1 or 2");
+  }
+  const size_t degree = coeff_.size() - 1;
+  const size_t shift = static_cast<size_t>(order);
+  const double chain = order == 2 ? scale_ * scale_ : scale_;
+  std::vector<double> d(degree >= shift ? degree - shift + 1 : 1, 0.0);
+  for (size_t k = shift; k <= degree; ++k) {
+    d[k - shift] = coeff_[k] * k * (order == 2 ? k - 1 : 1) * chain;
+  }
+  double x[kEvalBlock], value[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      x[j] = j < block ? (t[first + j] - begin) * scale_ : 0.0;
+      value[j] = d.back();
+    }
+    for (size_t k = d.size() - 1; k-- > 0;) {
+      const double c = d[k];
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        value[j] = value[j] * x[j] + c;
+      }
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
+double Approximation::getIntegral(double from, double to) {
+  double out;
+  integrate(&from, &to, &out, 1);
+  return out;
+}
+
+// Primitive sum(c(k) * x^(k + 1) / (k + 1)) / scale at both bounds
+void Approximation::integrate(const double* from, const double* to,
+                              double* out, size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Polynomial not inited");
+  }
+  auto primitive = [this](double t) {
+    const double x = (t - begin) * scale_;
+    double result = 0;
+    for (size_t k = coeff_.size(); k-- > 0;) {
+      result = (result + coeff_[k] / (k + 1)) * x;
+    }
+    return result / scale_;
+  };
+  for (size_t j = 0; j < count; ++j) {
+    out[j] = primitive(to[j]) - primitive(from[j]);
+  }
+}
+
+void Approximation::scaleTime(double& center, double& scale) const {
+  auto range = std::minmax_element(
+      points_.begin(), points_.end(),
+      [](const Point& a, const Point& b) { return a.first < b.first; });
+  center = (range.first->first + range.second->first) / 2;
+  const double half = (range.second->first - range.first->first) / 2;
+  scale = half > 0 ? 1.0 / half : 1.0;
+}
+
+// Columns x^0..x^degree of the Vandermonde matrix over the scaled time,
+// built and reduced kQrChunk rows at a time
+void Approximation::calculateCoeffQr(const int degree) {
+  const size_t cols = degree + 1;
+  double center, scale;
+  scaleTime(center, scale);
+  qr_.reset(cols);
+  std::vector<double> chunk(kQrChunk * cols), y(kQrChunk);
+  for (size_t first = 0; first < points_.size(); first += kQrChunk) {
+    const size_t rows = std::min(kQrChunk, points_.size() - first);
+    for (size_t i = 0; i < rows; ++i) {
+      // Rows of the weighted problem are scaled by sqrt(weight)
+      const double x = (points_[first + i].first - center) * scale;
+      double p = std::sqrt(weight(first + i));
+      y[i] = points_[first + i].second * p;
+      for (size_t j = 0; j < cols; ++j) {
+        chunk[j * rows + i] = p;
+        p *= x;
+      }
+    }
+    qr_.addRows(chunk.data(), y.data(), rows);
+  }
+  coeff_.resize(cols);
+  if (!qr_.solve(coeff_.data())) {
+    coeff_.clear();
+    std::cerr << "Error: incorrect SLAE matrix" << std::endl;
+    return;
+  }
+  begin += center;
+  scale_ = scale;
+}
+
+// Forsythe: one pass over the points per degree builds p(k + 1) from
+// p(k) and p(k - 1) and takes the projection of y on p(k), so the fits of
+// every degree up to the requested one come out of O(N * degree) work
+// with no system to solve. The residual of degree k is that of k - 1
+// less the energy ortho_coeff(k)^2 * |p(k)|^2 it explains.
+// With the auto degree on the same pass scores each degree by its
+// leave-one-out error: the hat matrix diagonal of degree k is
+// h(k) = h(k - 1) + w * p(k)^2 / |p(k)|^2, and the residual of point i
+// left out is e(i) / (1 - h(i))
+void Approximation::calculateCoeffOrthogonal(const int degree) {
+  const size_t n = points_.size(), max = degree;
+  double center, scale;
+  scaleTime(center, scale);
+  std::vector<double> x(n), w(n), p(n, 1.0), prev(n, 0.0);
+  std::vector<double> fit, hat;
+  double total = 0;
+  if (auto_degree_) {
+    fit.assign(n, 0);
+    hat.assign(n, 0);
+  }
+  double rss = 0;
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = (points_[i].first - center) * scale;
+    w[i] = weight(i);
+    rss += w[i] * points_[i].second * points_[i].second;
+    total += w[i];
   }
-  for (int i = 0; i < degree + 1; ++i) {
-    for (int j = i; j < degree + 1; ++j) {
-      slae_coeff_[i][j] = slae_coeff_[j][i] = calcSum(i + j);
+  alpha_.assign(max + 1, 0);
+  beta_.assign(max + 1, 0);
+  ortho_coeff_.assign(max + 1, 0);
+  double norm_prev = 1.0;
+  for (size_t k = 0; k <= max; ++k) {
+    double norm = 0, xnorm = 0, dot = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const double pp = w[i] * p[i] * p[i];
+      norm += pp;
+      xnorm += x[i] * pp;
+      dot += w[i] * points_[i].second * p[i];
     }
+    // Fewer distinct points than k + 1: p(k) vanishes on all of them. The
+    // auto degree just stops the search there
+    if (norm <= kEps * kEps * norm_prev && auto_degree_ && k > 0) {
+      break;
+    }
+    if (norm <= kEps * kEps * norm_prev) {
+      coeff_.clear();
+      alpha_.clear();
+      residuals_.clear();
+      std::cerr << "Error: incorrect SLAE matrix" << std::endl;
+      return;
+    }
+    ortho_coeff_[k] = dot / norm;
+    rss -= ortho_coeff_[k] * dot;
+    residuals_.push_back(std::max(rss, 0.0));
+    if (auto_degree_) {
+      scores_.push_back(looScore(p, w, norm, ortho_coeff_[k], fit, hat) /
+                        total);
+    }
+    if (k == max) break;
+    alpha_[k] = xnorm / norm;
+    beta_[k] = k > 0 ? norm / norm_prev : 0;
+    for (size_t i = 0; i < n; ++i) {
+      const double next = (x[i] - alpha_[k]) * p[i] - beta_[k] * prev[i];
+      prev[i] = p[i];
+      p[i] = next;
+    }
+    norm_prev = norm;
+  }
+  begin += center;
+  scale_ = scale;
+  if (auto_degree_) {
+    toPowerBasis(std::min_element(scores_.begin(), scores_.end()) -
+                 scores_.begin());
+  } else {
+    toPowerBasis(max);
+  }
+}
+
+// Adds p(k) to the fit and the hat diagonal, returns the weighted sum of
+// squared leave-one-out residuals; infinite once some point is fitted
+// exactly by construction (h = 1)
+double Approximation::looScore(const std::vector<double>& p,
+                               const std::vector<double>& w, double norm,
+                               double coeff, std::vector<double>& fit,
+                               std::vector<double>& hat) const {
+  double press = 0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    fit[i] += coeff * p[i];
+    hat[i] += w[i] * p[i] * p[i] / norm;
+    const double left = 1.0 - hat[i];
+    if (left <= kEps) return INFINITY;
+    const double r = (points_[i].second - fit[i]) / left;
+    press += w[i] * r * r;
+  }
+  return press;
+}
+
+bool Approximation::selectDegree(const int degree) {
+  if (alpha_.empty() || degree < 0 ||
+      static_cast<size_t>(degree) >= residuals_.size()) {
+    return false;
+  }
+  toPowerBasis(degree);
+  return true;
+}
+
+// coeff_ from the recurrence, power coefficients of p(k) kept for the
+// last two k only
+void Approximation::toPowerBasis(const size_t degree) {
+  ortho_degree_ = degree;
+  coeff_.assign(degree + 1, 0);
+  std::vector<double> p(degree + 2, 0), prev(degree + 2, 0), next;
+  p[0] = 1.0;
+  for (size_t k = 0; k <= degree; ++k) {
+    for (size_t j = 0; j <= k; ++j) {
+      coeff_[j] += ortho_coeff_[k] * p[j];
+    }
+    if (k == degree) break;
+    next.assign(degree + 2, 0);
+    for (size_t j = 0; j <= k; ++j) {
+      next[j + 1] += p[j];
+      next[j] -= alpha_[k] * p[j] + beta_[k] * prev[j];
+    }
+    prev.swap(p);
+    p.swap(next);
   }
-  for (int i = 0; i < degree + 1; ++i) {
-    slae_coeff_[i][degree + 1] = 0;
-    for (int j = 0; j < (int)points_.size(); ++j) {
-      slae_coeff_[i][degree + 1] +=
-          points_[j].second * pow(points_[j].first, i);
+}
+
+double Approximation::clenshaw(double x) const {
+  double b1 = 0, b2 = 0;
+  for (size_t k = ortho_degree_ + 1; k-- > 0;) {
+    const double beta = k + 1 <= ortho_degree_ ? beta_[k + 1] : 0;
+    const double b = ortho_coeff_[k] + (x - alpha_[k]) * b1 - beta * b2;
+    b2 = b1;
+    b1 = b;
+  }
+  return b1;
+}
+
+// clenshaw() over a kEvalBlock of points at once
+void Approximation::clenshaw(const double* x, double* out) const {
+  double b1[kEvalBlock]{}, b2[kEvalBlock]{};
+  for (size_t k = ortho_degree_ + 1; k-- > 0;) {
+    const double beta = k + 1 <= ortho_degree_ ? beta_[k + 1] : 0;
+    const double c = ortho_coeff_[k], a = alpha_[k];
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      const double b = c + (x[j] - a) * b1[j] - beta * b2[j];
+      b2[j] = b1[j];
+      b1[j] = b;
     }
   }
+  std::copy(b1, b1 + kEvalBlock, out);
+}
+
+void Approximation::calculateMatrixSLAE(const int degree) {
+  slae_coeff_.resize((degree + 1) * (degree + 1));
+  calcPowerSums(degree);
+  normalMatrix(power_sums_, degree, slae_coeff_.data());
 }
 
-double Approximation::calcSum(const int degree) {
-  double result = 0;
-  for (int i = 0; i < (int)points_.size(); ++i) {
-    result += pow(points_[i].first, degree);
+void Approximation::calcPowerSums(const int degree) {
+  Weighting weighting;
+  weighting.weights = weights_.empty() ? nullptr : weights_.data();
+  weighting.latest = points_.back().first;
+  weighting.rate = half_life_ > 0 ? 1.0 / half_life_ : 0.0;
+  powerSums(points_, degree, power_sums_, moments_, *pool_, weighting);
+}
+
+std::vector<std::vector<double>> Approximation::fitBatch(
+    const std::vector<std::vector<Point>>& series, const int degree) {
+  const size_t n = degree + 1, count = series.size();
+  std::vector<double> slae(count * n * n), rhs(count * n), sums;
+  std::vector<double> moments;
+  for (size_t s = 0; s < count; ++s) {
+    powerSums(series[s], degree, sums, moments, ThreadPool::GetInstance());
+    normalMatrix(sums, degree, slae.data() + s * n * n);
+    std::copy(moments.begin(), moments.end(), rhs.begin() + s * n);
+  }
+  solveBatch(slae.data(), rhs.data(), rhs.data(), n, count);
+  std::vector<std::vector<double>> result(count);
+  for (size_t s = 0; s < count; ++s) {
+    if (series[s].empty() || std::isnan(rhs[s * n])) continue;
+    result[s].assign(rhs.begin() + s * n, rhs.begin() + (s + 1) * n);
   }
   return result;
 }
@@ -11,8 +11,10 @@
 #include <stdexcept>
 #include <vector>
 
+#include "../ThreadPool/thread_pool.h"
 #include "../types.h"
-#include "gauss.h"
+#include "batch_solver.h"
+#include "qr_least_squares.h"
 
 namespace s21 {
 
@@ -26,20 +28,107 @@ class Approximation {
   void operator=(Approximation&&) = delete;
 
   auto initApproximation(const std::vector<Point>&, const int degree) -> void;
-  auto initApproximation(std::vector<DataPoint>&, const int degree) -> void;
+  auto initApproximation(const TimeSeries&, const int degree) -> void;
+  // Weighted least squares, one weight per point (empty for uniform)
+  auto initApproximation(const std::vector<Point>&,
+                         const std::vector<double>& weights, const int degree)
+      -> void;
+  auto initApproximation(const TimeSeries&, const std::vector<double>& weights,
+                         const int degree) -> void;
+  // Weights halve every half_life units of t (seconds for a TimeSeries)
+  // back from the last point, on top of the per-point ones; 0 switches the
+  // decay off
+  auto setHalfLife(double half_life) -> void;
+  auto getHalfLife() const -> double { return half_life_; }
+
+  // kQr and kOrthogonal fit over time centered and scaled to [-1, 1]; the
+  // coefficients are then those of the polynomial in
+  // (t - getShift()) * getScale()
+  auto setMethod(ApproxMethod method) -> void { method_ = method; }
+  auto getMethod() const -> ApproxMethod { return method_; }
+  // Pool of the normal-equation sums, the shared one by default; the sums
+  // come out the same whatever its size
+  auto setThreadPool(ThreadPool& pool) -> void { pool_ = &pool; }
 
   auto getCoeff() -> std::vector<double>&;
+  auto getShift() const -> double { return begin; }
+  auto getScale() const -> double { return scale_; }
   auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+  // Derivatives of order 1 or 2 and definite integrals from the power
+  // coefficients, whatever the method
+  auto getDerivative(double t, int order = 1) -> double;
+  auto evaluateDerivative(const double* t, double* out, size_t count,
+                          int order = 1) -> void;
+  auto getIntegral(double from, double to) -> double;
+  auto integrate(const double* from, const double* to, double* out,
+                 size_t count) -> void;
+
+  // kOrthogonal only: switches to any degree up to the fitted one without
+  // a refit; false if that degree was not computed
+  auto selectDegree(const int degree) -> bool;
+  // kOrthogonal only: sum of squared residuals of the fits of degree
+  // 0..fitted
+  auto getResiduals() const -> const std::vector<double>& {
+    return residuals_;
+  }
+
+  // With the auto degree on, the degree passed to initApproximation() is
+  // the highest tried: every degree up to it is scored by leave-one-out
+  // error in the orthogonal-polynomial pass (whatever the method) and the
+  // best one is kept
+  auto setAutoDegree(bool on) -> void { auto_degree_ = on; }
+  auto getAutoDegree() const -> bool { return auto_degree_; }
+  // Degree of the current coefficients, -1 before a fit
+  auto getDegree() const -> int { return static_cast<int>(coeff_.size()) - 1; }
+  // Auto degree only: weighted mean squared leave-one-out error of the
+  // degrees 0..highest tried, infinite where undefined
+  auto getScores() const -> const std::vector<double>& { return scores_; }
+
+  // Coefficients of one fit per point set, all normal equations solved
+  // by one solveBatch() call; a singular fit gives an empty vector
+  static auto fitBatch(const std::vector<std::vector<Point>>& series,
+                       const int degree) -> std::vector<std::vector<double>>;
 
  private:
   auto calculateCoeff(const int degree) -> void;
   auto calculateMatrixSLAE(const int degree) -> void;
-  auto calcSum(const int degree) -> double;
+  auto calcPowerSums(const int degree) -> void;
+  auto calculateCoeffQr(const int degree) -> void;
+  auto calculateCoeffOrthogonal(const int degree) -> void;
+  auto toPowerBasis(const size_t degree) -> void;
+  auto looScore(const std::vector<double>& p, const std::vector<double>& w,
+                double norm, double coeff, std::vector<double>& fit,
+                std::vector<double>& hat) const -> double;
+  auto clenshaw(double x) const -> double;
+  auto clenshaw(const double* x, double* out) const -> void;
+  auto scaleTime(double& center, double& scale) const -> void;
+  auto setWeights(const std::vector<double>& weights, size_t count) -> void;
+  auto weight(size_t i) const -> double;
 
-  Matrix slae_coeff_{};
+  // (degree + 1)^2 row-major normal matrix and its right-hand side
+  std::vector<double> slae_coeff_{};
+  std::vector<double> power_sums_{};
+  std::vector<double> moments_{};
   std::vector<double> coeff_{};
   std::vector<Point> points_{};
+  std::vector<double> weights_{};
+  double half_life_{0};
   double begin{};
+  double scale_{1.0};
+  ApproxMethod method_{ApproxMethod::kNormalEquations};
+  QrLeastSquares qr_;
+  ThreadPool* pool_{&ThreadPool::GetInstance()};
+  // p(k + 1) = (x - alpha(k)) * p(k) - beta(k) * p(k - 1), the fit being
+  // sum(ortho_coeff(k) * p(k)) for k up to ortho_degree_
+  std::vector<double> alpha_{};
+  std::vector<double> beta_{};
+  std::vector<double> ortho_coeff_{};
+  std::vector<double> residuals_{};
+  std::vector<double> scores_{};
+  bool auto_degree_{false};
+  size_t ortho_degree_{0};
 };
 
 }  //   namespace s21
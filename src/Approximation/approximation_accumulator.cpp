@@ -0,0 +1,185 @@
+#include "approximation_accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "batch_solver.h"
+
+namespace s21 {
+
+ApproximationAccumulator::ApproximationAccumulator(int degree, double origin,
+                                                   double scale)
+    : power_sums_(2 * degree + 1),
+      moments_(degree + 1),
+      degree_(degree),
+      origin_(origin),
+      scale_(scale) {
+  if (degree < 0 || !(scale > 0)) {
+    throw std::invalid_argument("Error: incorrect accumulator parameters");
+  }
+}
+
+void ApproximationAccumulator::add(double t, double y, double weight) {
+  decayTo(t);
+  accumulate(t, y, weight * decay(t));
+  ++count_;
+}
+
+void ApproximationAccumulator::add(const std::vector<Point>& points) {
+  for (auto& it : points) add(it.first, it.second);
+}
+
+void ApproximationAccumulator::add(const TimeSeries& data_points) {
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    add(static_cast<double>(data_points.time[i]), data_points.value[i]);
+  }
+}
+
+void ApproximationAccumulator::remove(double t, double y, double weight) {
+  if (!count_) {
+    throw std::out_of_range("Error: accumulator is empty");
+  }
+  accumulate(t, y, -weight * decay(t));
+  if (!--count_) clear();
+}
+
+void ApproximationAccumulator::setHalfLife(double half_life) {
+  if (count_) {
+    throw std::logic_error("Error: half-life of a non-empty accumulator");
+  }
+  if (!(half_life >= 0)) {
+    throw std::invalid_argument("Error: negative half-life");
+  }
+  half_life_ = half_life;
+}
+
+double ApproximationAccumulator::decay(double t) const {
+  return half_life_ > 0 ? std::exp2((t - latest_) / half_life_) : 1.0;
+}
+
+void ApproximationAccumulator::decayTo(double t) {
+  if (!count_) {
+    latest_ = t;
+  } else if (half_life_ > 0 && t > latest_) {
+    const double factor = std::exp2((latest_ - t) / half_life_);
+    for (auto& it : power_sums_) it *= factor;
+    for (auto& it : moments_) it *= factor;
+    latest_ = t;
+  }
+}
+
+// Powers by running multiplication, as Approximation::calcPowerSums
+void ApproximationAccumulator::accumulate(double t, double y, double weight) {
+  const double x = (t - origin_) * scale_;
+  const size_t moments = degree_ + 1, sums = 2 * degree_ + 1;
+  double p = weight;
+  size_t k = 0;
+  for (; k < moments; ++k) {
+    power_sums_[k] += p;
+    moments_[k] += y * p;
+    p *= x;
+  }
+  for (; k < sums; ++k) {
+    power_sums_[k] += p;
+    p *= x;
+  }
+}
+
+// With x = a * u + b relating the two variables, sum(x^k * w) =
+// sum over j of C(k, j) * a^j * b^(k - j) * sum(u^j * w)
+void ApproximationAccumulator::rebase(const ApproximationAccumulator& other,
+                                      double a, double b) {
+  const size_t sums = power_sums_.size(), moments = moments_.size();
+  // binomial(k, j) * a^j * b^(k - j), row k built from row k - 1
+  row_.assign(sums, 0);
+  next_.assign(sums, 0);
+  sums_.assign(sums, 0);
+  rebased_moments_.assign(moments, 0);
+  row_[0] = 1.0;
+  for (size_t k = 0; k < sums; ++k) {
+    for (size_t j = 0; j <= k; ++j) {
+      sums_[k] += row_[j] * other.power_sums_[j];
+      if (k < moments) rebased_moments_[k] += row_[j] * other.moments_[j];
+    }
+    next_[0] = b * row_[0];
+    for (size_t j = 1; j <= k + 1 && j < sums; ++j) {
+      next_[j] = b * row_[j] + a * row_[j - 1];
+    }
+    row_.swap(next_);
+  }
+}
+
+void ApproximationAccumulator::merge(const ApproximationAccumulator& other) {
+  if (other.degree_ != degree_) {
+    throw std::invalid_argument("Error: accumulators of different degree");
+  }
+  if (other.half_life_ != half_life_) {
+    throw std::invalid_argument("Error: accumulators of different half-life");
+  }
+  if (!other.count_) return;
+  rebase(other, scale_ / other.scale_, (other.origin_ - origin_) * scale_);
+  // Both sides decayed to the later of the two latest times
+  const double latest = other.latest_;
+  decayTo(latest);
+  const double factor = decay(latest);
+  for (size_t k = 0; k < power_sums_.size(); ++k) {
+    power_sums_[k] += factor * sums_[k];
+  }
+  for (size_t k = 0; k < moments_.size(); ++k) {
+    moments_[k] += factor * rebased_moments_[k];
+  }
+  count_ += other.count_;
+}
+
+void ApproximationAccumulator::setOrigin(double origin) {
+  rebase(*this, 1.0, (origin_ - origin) * scale_);
+  power_sums_.swap(sums_);
+  moments_.swap(rebased_moments_);
+  origin_ = origin;
+}
+
+void ApproximationAccumulator::clear() {
+  std::fill(power_sums_.begin(), power_sums_.end(), 0);
+  std::fill(moments_.begin(), moments_.end(), 0);
+  count_ = 0;
+  latest_ = 0;
+}
+
+std::vector<double> ApproximationAccumulator::getCoeff(int degree) const {
+  if (degree < 0) degree = degree_;
+  if (degree > degree_) {
+    throw std::invalid_argument("Error: degree above the accumulated one");
+  }
+  const size_t n = degree + 1;
+  std::vector<double> coeff;
+  if (count_ < n) return coeff;
+  double slae[kBatchMaxSize * kBatchMaxSize];
+  std::vector<double> matrix;
+  double* a = slae;
+  if (n > kBatchMaxSize) {
+    matrix.resize(n * n);
+    a = matrix.data();
+  }
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) a[i * n + j] = power_sums_[i + j];
+  }
+  coeff.resize(n);
+  if (solveBatch(a, moments_.data(), coeff.data(), n, 1)) coeff.clear();
+  return coeff;
+}
+
+double ApproximationAccumulator::getValue(double t, int degree) const {
+  std::vector<double> coeff = getCoeff(degree);
+  if (coeff.empty()) {
+    throw std::domain_error("Error: Polynomial not inited");
+  }
+  const double x = (t - origin_) * scale_;
+  double result = coeff.back();
+  for (size_t i = coeff.size() - 1; i-- > 0;) {
+    result = result * x + coeff[i];
+  }
+  return result;
+}
+
+}  //   namespace s21
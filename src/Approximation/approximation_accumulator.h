@@ -0,0 +1,90 @@
+#ifndef SRC_APPROXIMATION_APPROXIMATION_ACCUMULATOR_H_
+#define SRC_APPROXIMATION_APPROXIMATION_ACCUMULATOR_H_
+
+//
+// Online least squares: keeps only the 2 * degree + 1 power sums and the
+// degree + 1 moments of the normal equations, so memory does not grow
+// with the history. Points are added and removed (sliding windows) in
+// O(degree) each and coefficients are solved for on demand.
+// Sums are taken over x = (t - origin) * scale; pick the origin near the
+// data and the scale so x stays around 1 (e.g. 1 / kSecInDay for daily
+// epoch seconds), the raw epoch powers overflow the precision quickly.
+// Points may carry weights, and with a half-life set every point added
+// later in time first scales the sums down by the decay since the latest
+// point, so exponential forgetting costs O(degree) per point too.
+//
+
+#include <vector>
+
+#include "../types.h"
+
+namespace s21 {
+
+class ApproximationAccumulator {
+ public:
+  explicit ApproximationAccumulator(int degree, double origin = 0,
+                                    double scale = 1);
+  ~ApproximationAccumulator() = default;
+
+  auto add(double t, double y, double weight = 1.0) -> void;
+  auto add(const std::vector<Point>& points) -> void;
+  auto add(const TimeSeries& data_points) -> void;
+  // Takes back a point added with the same weight
+  auto remove(double t, double y, double weight = 1.0) -> void;
+  // Adds the points of other, which may use another origin and scale but
+  // not another half-life
+  auto merge(const ApproximationAccumulator& other) -> void;
+  // Weights halve every half_life units of t back from the latest point;
+  // 0 switches the decay off. Only on an empty accumulator
+  auto setHalfLife(double half_life) -> void;
+  // Moves the origin keeping the points, O(degree^2); lets a sliding
+  // window keep x small as it moves along the time
+  auto setOrigin(double origin) -> void;
+  auto clear() -> void;
+
+  // Coefficients of the fit of the given degree (the accumulator's by
+  // default) in (t - getOrigin()) * getScale(); empty when there are too
+  // few points or the system is singular
+  auto getCoeff(int degree = -1) const -> std::vector<double>;
+  auto getValue(double t, int degree = -1) const -> double;
+
+  auto getDegree() const -> int { return degree_; }
+  auto getOrigin() const -> double { return origin_; }
+  auto getScale() const -> double { return scale_; }
+  auto getHalfLife() const -> double { return half_life_; }
+  // Time of the latest point, the one of weight 1 under decay
+  auto getLatest() const -> double { return latest_; }
+  auto size() const -> size_t { return count_; }
+  // sum(x^k), k = 0..2 * degree, and sum(y * x^k), k = 0..degree
+  auto getPowerSums() const -> const std::vector<double>& {
+    return power_sums_;
+  }
+  auto getMoments() const -> const std::vector<double>& { return moments_; }
+
+ private:
+  auto accumulate(double t, double y, double weight) -> void;
+  // Decay of a point at t relative to the latest one
+  auto decay(double t) const -> double;
+  // Moves the latest time up to t, scaling the sums down
+  auto decayTo(double t) -> void;
+  // Sums of other over x = a * u + b into sums_ / moments_ of this
+  auto rebase(const ApproximationAccumulator& other, double a, double b)
+      -> void;
+
+  std::vector<double> power_sums_{};
+  std::vector<double> moments_{};
+  std::vector<double> row_{};
+  std::vector<double> next_{};
+  std::vector<double> sums_{};
+  std::vector<double> rebased_moments_{};
+  int degree_;
+  double origin_;
+  double scale_;
+  double half_life_{0};
+  double latest_{0};
+  size_t count_{0};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_APPROXIMATION_APPROXIMATION_ACCUMULATOR_H_
@@ -0,0 +1,200 @@
+#include "batch_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "lu_solver.h"
+
+namespace s21 {
+
+namespace {
+
+constexpr size_t kLanes = kBatchLanes;
+
+// Element (i, j) of lane l sits at m[(i * n + j) * kLanes + l]; after
+// factorize() m holds U and the multipliers of L as in LuSolver
+struct Group {
+  double m[kBatchMaxSize * kBatchMaxSize * kLanes];
+  double x[kBatchMaxSize * kLanes];
+  double residual[kBatchMaxSize * kLanes];
+  size_t pivot[kBatchMaxSize * kLanes];
+  bool singular[kLanes];
+};
+
+// Systems [first, first + lanes) into the group, the unused lanes padded
+// with the identity so they stay regular
+void loadGroup(Group& g, const double* a, size_t n, size_t first,
+               size_t lanes) {
+  for (size_t l = 0; l < kLanes; ++l) {
+    g.singular[l] = false;
+    if (l < lanes) {
+      const double* src = a + (first + l) * n * n;
+      for (size_t e = 0; e < n * n; ++e) g.m[e * kLanes + l] = src[e];
+    } else {
+      for (size_t e = 0; e < n * n; ++e) g.m[e * kLanes + l] = 0;
+      for (size_t i = 0; i < n; ++i) g.m[(i * n + i) * kLanes + l] = 1;
+    }
+  }
+}
+
+void factorize(Group& g, size_t n) {
+  double inv[kLanes];
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t l = 0; l < kLanes; ++l) {
+      size_t p = k;
+      double max = std::fabs(g.m[(k * n + k) * kLanes + l]);
+      for (size_t i = k + 1; i < n; ++i) {
+        double value = std::fabs(g.m[(i * n + k) * kLanes + l]);
+        if (value > max) {
+          max = value;
+          p = i;
+        }
+      }
+      g.pivot[k * kLanes + l] = p;
+      if (!(max > 0)) {
+        g.singular[l] = true;
+        inv[l] = 0;
+        continue;
+      }
+      if (p != k) {
+        for (size_t j = 0; j < n; ++j) {
+          std::swap(g.m[(k * n + j) * kLanes + l],
+                    g.m[(p * n + j) * kLanes + l]);
+        }
+      }
+      inv[l] = 1.0 / g.m[(k * n + k) * kLanes + l];
+    }
+    // A local copy of the pivot row lets the lane loops vectorize without
+    // runtime alias checks
+    double pivot_row[kBatchMaxSize * kLanes];
+    std::copy(g.m + k * n * kLanes, g.m + (k + 1) * n * kLanes, pivot_row);
+    for (size_t i = k + 1; i < n; ++i) {
+      double* row = g.m + i * n * kLanes;
+      double factor[kLanes];
+      for (size_t l = 0; l < kLanes; ++l) {
+        factor[l] = row[k * kLanes + l] * inv[l];
+        row[k * kLanes + l] = factor[l];
+      }
+      for (size_t j = k + 1; j < n; ++j) {
+        for (size_t l = 0; l < kLanes; ++l) {
+          row[j * kLanes + l] -= factor[l] * pivot_row[j * kLanes + l];
+        }
+      }
+    }
+  }
+}
+
+// v = A^-1 * v for every lane, v interleaved like the matrix. Works on a
+// local copy for the same reason as factorize()
+void solve(const Group& g, double* v, size_t n) {
+  double w[kBatchMaxSize * kLanes];
+  std::copy(v, v + n * kLanes, w);
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t l = 0; l < kLanes; ++l) {
+      std::swap(w[k * kLanes + l], w[g.pivot[k * kLanes + l] * kLanes + l]);
+    }
+  }
+  for (size_t i = 1; i < n; ++i) {
+    const double* row = g.m + i * n * kLanes;
+    for (size_t j = 0; j < i; ++j) {
+      for (size_t l = 0; l < kLanes; ++l) {
+        w[i * kLanes + l] -= row[j * kLanes + l] * w[j * kLanes + l];
+      }
+    }
+  }
+  for (size_t i = n; i-- > 0;) {
+    const double* row = g.m + i * n * kLanes;
+    for (size_t j = i + 1; j < n; ++j) {
+      for (size_t l = 0; l < kLanes; ++l) {
+        w[i * kLanes + l] -= row[j * kLanes + l] * w[j * kLanes + l];
+      }
+    }
+    for (size_t l = 0; l < kLanes; ++l) {
+      w[i * kLanes + l] /= row[i * kLanes + l];
+    }
+  }
+  std::copy(w, w + n * kLanes, v);
+}
+
+// Solve, then one step of iterative refinement against the original
+// matrices with the residual accumulated in extended precision, as
+// Gauss::getResultSLAE() does
+void solveGroup(Group& g, const double* a, const double* b, double* x,
+                size_t n, size_t first, size_t lanes) {
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t l = 0; l < kLanes; ++l) {
+      g.x[i * kLanes + l] = l < lanes ? b[(first + l) * n + i] : 0;
+    }
+  }
+  solve(g, g.x, n);
+  for (size_t l = 0; l < kLanes; ++l) {
+    const double* src = a + (first + l) * n * n;
+    for (size_t i = 0; i < n; ++i) {
+      long double sum = 0;
+      if (l < lanes) {
+        sum = b[(first + l) * n + i];
+        for (size_t j = 0; j < n; ++j) {
+          sum -= static_cast<long double>(src[i * n + j]) * g.x[j * kLanes + l];
+        }
+      }
+      g.residual[i * kLanes + l] = static_cast<double>(sum);
+    }
+  }
+  solve(g, g.residual, n);
+  for (size_t l = 0; l < lanes; ++l) {
+    double* dst = x + (first + l) * n;
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = g.singular[l]
+                   ? std::numeric_limits<double>::quiet_NaN()
+                   : g.x[i * kLanes + l] + g.residual[i * kLanes + l];
+    }
+  }
+}
+
+}  //   namespace
+
+size_t solveBatch(const double* a, const double* b, double* x, size_t n,
+                  size_t count) {
+  size_t singular = 0;
+  if (n > kBatchMaxSize) {
+    // Same refinement step as solveGroup(), one system at a time
+    LuSolver lu;
+    std::vector<double> residual(n);
+    for (size_t s = 0; s < count; ++s) {
+      const double* src = a + s * n * n;
+      double* dst = x + s * n;
+      lu.factorize(src, n);
+      if (lu.isSingular()) {
+        ++singular;
+        std::fill(dst, dst + n, std::numeric_limits<double>::quiet_NaN());
+        continue;
+      }
+      lu.solve(b + s * n, dst);
+      for (size_t i = 0; i < n; ++i) {
+        long double sum = b[s * n + i];
+        for (size_t j = 0; j < n; ++j) {
+          sum -= static_cast<long double>(src[i * n + j]) * dst[j];
+        }
+        residual[i] = static_cast<double>(sum);
+      }
+      lu.solve(residual.data(), residual.data());
+      for (size_t i = 0; i < n; ++i) {
+        dst[i] += residual[i];
+      }
+    }
+    return singular;
+  }
+  Group g;
+  for (size_t first = 0; first < count; first += kLanes) {
+    const size_t lanes = std::min(kLanes, count - first);
+    loadGroup(g, a, n, first, lanes);
+    factorize(g, n);
+    solveGroup(g, a, b, x, n, first, lanes);
+    singular += std::count(g.singular, g.singular + lanes, true);
+  }
+  return singular;
+}
+
+}  //   namespace s21
@@ -0,0 +1,29 @@
+#ifndef SRC_APPROXIMATION_BATCH_SOLVER_H_
+#define SRC_APPROXIMATION_BATCH_SOLVER_H_
+
+//
+// Many small independent systems A_s * x_s = b_s solved together. Groups
+// of kBatchLanes systems are interleaved element by element in stack
+// buffers, so every elimination step runs the same loop over the group
+// and the compiler vectorizes it across systems. Partial pivoting is kept
+// per system; only the row swaps are done lane by lane.
+// Systems larger than kBatchMaxSize go through LuSolver one at a time.
+//
+
+#include <cstddef>
+
+namespace s21 {
+
+constexpr size_t kBatchLanes = 8;
+// Normal equations of a degree 20 polynomial
+constexpr size_t kBatchMaxSize = 21;
+
+// a holds count n x n row-major matrices back to back, b and x count
+// vectors of n. b and x may be the same array. A singular system gets NaN
+// in its x; returns the number of singular systems
+auto solveBatch(const double* a, const double* b, double* x, size_t n,
+                size_t count) -> size_t;
+
+}  //   namespace s21
+
+#endif  //  SRC_APPROXIMATION_BATCH_SOLVER_H_
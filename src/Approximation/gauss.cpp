@@ -1,7 +1,18 @@
 #include "gauss.h"
 
+#include <algorithm>
+
 namespace s21 {
 
+namespace {
+
+// Share of the working set one task of the parallel elimination updates
+constexpr size_t kBlockBytes = 32 * 1024;
+// Panel width of the blocked LU
+constexpr size_t kLuBlock = 64;
+
+}  //  namespace
+
 void Gauss::loadFromFile(const std::string &fileName) {
   std::ifstream fp(fileName);
   if (fp.is_open()) {
@@ -63,7 +74,6 @@ void Gauss::clearData() {
 }
 
 void Gauss::updateEquation(int row, int col, int base_row) {
-  // std::lock_guard<std::mutex> lock(mtx_);
   double coff = spare_matrix_[row][col] / spare_matrix_[base_row][col];
   for (int j = col; j < cols_; ++j) {
     spare_matrix_[row][j] -= spare_matrix_[base_row][j] * coff;
@@ -89,113 +99,120 @@ void Gauss::calculateGauss() {
   normalizeMatrix();
 }
 
+// Every pivot step is one barrier: the trailing rows are updated in blocks
+// of about kBlockBytes by the pool
 void Gauss::calculateGaussParallels() {
-  const int num_threads = std::thread::hardware_concurrency();
   spare_matrix_ = matrix_;
-  // auto job = [this](int i, int k) { updateEquation(i, k, k); };
-  std::vector<std::thread> threads(num_threads);
-
-  int cur_thread = 0;
+  const size_t grain =
+      std::max<size_t>(1, kBlockBytes / (sizeof(double) * cols_));
   for (int k = 0; k < rows_ - 1; ++k) {
-    for (int i = k + 1; i < rows_; ++i) {
-      threads[cur_thread++] =
-          std::move(std::thread{[this, i, k]() { updateEquation(i, k, k); }});
-      if (cur_thread == num_threads) {
-        for (auto &it : threads) {
-          it.join();
-        }
-        cur_thread = 0;
+    pool_->parallelFor(k + 1, rows_, grain, [this, k](size_t begin,
+                                                      size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        updateEquation(static_cast<int>(i), k, k);
       }
-    }
-    for (auto &it : threads) {
-      if (it.joinable()) {
-        it.join();
-      }
-    }
-    cur_thread = 0;
+    });
   }
   normalizeMatrix();
 }
 
+// Same elimination split by column blocks instead of rows, with the row
+// factors taken before any column changes
 void Gauss::calculateGaussParallelsExtra() {
-  const int num_threads = std::thread::hardware_concurrency();
   spare_matrix_ = matrix_;
-
-  auto job = [this](int k) {
-    for (int i = k + 1; i < rows_; ++i) {
-      updateEquation(i, k, k);
-    }
-  };
-  std::vector<std::thread> threads(num_threads);
-
-  int cur_thread = 0;
+  factors_.resize(rows_);
+  const size_t grain =
+      std::max<size_t>(1, kBlockBytes / (sizeof(double) * rows_));
   for (int k = 0; k < rows_ - 1; ++k) {
-    threads[cur_thread++] = std::move(std::thread{job, k});
-    if (cur_thread == num_threads) {
-      for (auto &it : threads) {
-        it.join();
-      }
-      cur_thread = 0;
+    for (int i = k + 1; i < rows_; ++i) {
+      factors_[i] = spare_matrix_[i][k] / spare_matrix_[k][k];
     }
-    for (auto &it : threads) {
-      if (it.joinable()) {
-        it.join();
+    pool_->parallelFor(k, cols_, grain, [this, k](size_t begin, size_t end) {
+      for (int i = k + 1; i < rows_; ++i) {
+        for (size_t j = begin; j < end; ++j) {
+          spare_matrix_[i][j] -= spare_matrix_[k][j] * factors_[i];
+        }
       }
-    }
-    cur_thread = 0;
+    });
   }
   normalizeMatrix();
 }
 
-std::vector<double> &Gauss::getResultWithoutParallelAlgo() {
-  calculateGauss();
-  result_.clear();
+// Rows of the normalized upper triangle, solved bottom up into a result
+// sized once. strict: a NaN throws instead of leaving the row unsolved
+void Gauss::backSubstitution(bool strict) {
+  result_.assign(rows_, 0);
+  int solved = rows_;
   for (int i = rows_ - 1; i >= 0; --i) {
     double tmp = 0;
-    for (int j = 0; j < (int)result_.size(); ++j) {
-      tmp += result_[j] * spare_matrix_[i][i + 1 + j];
+    for (int j = i + 1; j < rows_; ++j) {
+      tmp += result_[j] * spare_matrix_[i][j];
     }
-    if (std::isnan(tmp)) {
+    if (strict && std::isnan(tmp)) {
       throw std::invalid_argument("Error: incorrect SLAE matrix");
     }
-    result_.insert(result_.begin(), spare_matrix_[i][cols_ - 1] - tmp);
+    if (strict || !std::isnan(spare_matrix_[i][cols_ - 1])) {
+      result_[--solved] = spare_matrix_[i][cols_ - 1] - tmp;
+    }
   }
+  result_.erase(result_.begin(), result_.begin() + solved);
+}
+
+std::vector<double> &Gauss::getResultWithoutParallelAlgo() {
+  if (mode_ == SlaeMode::kBlockedLu) {
+    return solveLu(matrix_, nullptr);
+  }
+  calculateGauss();
+  backSubstitution(true);
   return result_;
 }
 
 std::vector<double> &Gauss::getResultWithParallelAlgo() {
-  calculateGaussParallels();
-  result_.clear();
-  for (int i = rows_ - 1; i >= 0; --i) {
-    double tmp = 0;
-    for (int j = 0; j < (int)result_.size(); ++j) {
-      tmp += result_[j] * spare_matrix_[i][i + 1 + j];
-    }
-    if (std::isnan(tmp)) {
-      throw std::invalid_argument("Error: incorrect SLAE matrix");
-    }
-    result_.insert(result_.begin(), spare_matrix_[i][cols_ - 1] - tmp);
+  if (mode_ == SlaeMode::kBlockedLu) {
+    return solveLu(matrix_, pool_);
   }
+  calculateGaussParallels();
+  backSubstitution(true);
   return result_;
 }
 
 std::vector<double> &Gauss::getResultSLAE(const Matrix &matrix) {
-  matrix_ = matrix;
-  rows_ = matrix_.size();
+  rows_ = matrix.size();
   cols_ = rows_ + 1;
+  if (mode_ == SlaeMode::kElimination) {
+    matrix_ = matrix;
+    calculateGauss();
+    backSubstitution(false);
+    return result_;
+  }
+  return solveLu(matrix, nullptr);
+}
 
-  calculateGauss();
-  result_.clear();
-  for (int i = rows_ - 1; i >= 0; --i) {
-    double tmp = 0;
-    for (int j = 0; j < (int)result_.size(); ++j) {
-      tmp += result_[j] * spare_matrix_[i][i + 1 + j];
-    }
-    if (!std::isnan(spare_matrix_[i][cols_ - 1])) {
-      result_.insert(result_.begin(), spare_matrix_[i][cols_ - 1] - tmp);
-    } else {
-      // throw std::invalid_argument("Error: incorrect SLAE matrix");
+std::vector<double> &Gauss::solveLu(const Matrix &matrix, ThreadPool *pool) {
+  lu_.setBlockSize(mode_ == SlaeMode::kBlockedLu ? kLuBlock : 0);
+  lu_.setThreadPool(pool);
+  lu_.factorize(matrix);
+  if (lu_.isSingular()) {
+    throw std::invalid_argument("Error: incorrect SLAE matrix");
+  }
+  result_.resize(rows_);
+  for (int i = 0; i < rows_; ++i) {
+    result_[i] = matrix[i][cols_ - 1];
+  }
+  lu_.solve(result_);
+  // One step of iterative refinement, residual of the original matrix
+  // accumulated in extended precision
+  std::vector<double> residual(rows_);
+  for (int i = 0; i < rows_; ++i) {
+    long double sum = matrix[i][cols_ - 1];
+    for (int j = 0; j < rows_; ++j) {
+      sum -= static_cast<long double>(matrix[i][j]) * result_[j];
     }
+    residual[i] = static_cast<double>(sum);
+  }
+  lu_.solve(residual);
+  for (int i = 0; i < rows_; ++i) {
+    result_[i] += residual[i];
   }
   return result_;
 }
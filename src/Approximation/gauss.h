@@ -4,15 +4,22 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
-#include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include "../ThreadPool/thread_pool.h"
+#include "lu_solver.h"
+
 namespace s21 {
 
 using Matrix = std::vector<std::vector<double>>;
 
+// Backend of getResultSLAE(): plain elimination without pivoting, or the
+// partially pivoted LuSolver, unblocked or by panels. kBlockedLu also
+// drives getResultWithoutParallelAlgo() / getResultWithParallelAlgo(),
+// the latter updating the tiles on the thread pool
+enum class SlaeMode { kElimination, kPivotedLu, kBlockedLu };
+
 class Gauss {
  public:
   Gauss() = default;
@@ -27,6 +34,12 @@ class Gauss {
   auto getResultWithParallelAlgo() -> std::vector<double> &;
   auto getResultSLAE(const Matrix &matrix) -> std::vector<double> &;
 
+  auto setMode(SlaeMode mode) -> void { mode_ = mode; }
+  auto getMode() const -> SlaeMode { return mode_; }
+  // Pool of the parallel algorithm, the shared one by default
+  auto setThreadPool(ThreadPool &pool) -> void { pool_ = &pool; }
+  const LuSolver &getSolver() const { return lu_; }
+
   Matrix &getMatrix() { return matrix_; }
   Matrix &getSpareMatrix() { return spare_matrix_; }
 
@@ -36,13 +49,19 @@ class Gauss {
   auto calculateGaussParallelsExtra() -> void;
   auto updateEquation(int row, int col, int base_row) -> void;
   auto normalizeMatrix() -> void;
+  auto backSubstitution(bool strict) -> void;
+  auto solveLu(const Matrix &matrix, ThreadPool *pool)
+      -> std::vector<double> &;
 
   Matrix matrix_;
   Matrix spare_matrix_;
   std::vector<double> result_;
   int cols_{0};
   int rows_{0};
-  std::mutex mtx_;
+  SlaeMode mode_{SlaeMode::kPivotedLu};
+  LuSolver lu_;
+  ThreadPool *pool_{&ThreadPool::GetInstance()};
+  std::vector<double> factors_;
 };
 
 }  //  namespace s21
@@ -0,0 +1,218 @@
+#include "lu_solver.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+// Trailing update: rows per task, columns per cache block, register tile
+constexpr size_t kTileRows = 64;
+constexpr size_t kTileCols = 256;
+constexpr size_t kKernel = 4;
+
+}  //   namespace
+
+void LuSolver::factorize(const Matrix& matrix) {
+  n_ = matrix.size();
+  lu_.resize(n_ * n_);
+  for (size_t i = 0; i < n_; ++i) {
+    if (matrix[i].size() < n_) {
+      throw std::invalid_argument("Error: incorrect SLAE matrix");
+    }
+    std::copy(matrix[i].begin(), matrix[i].begin() + n_,
+              lu_.begin() + i * n_);
+  }
+  decompose();
+}
+
+void LuSolver::factorize(std::vector<double>&& matrix, size_t n) {
+  if (matrix.size() != n * n) {
+    throw std::invalid_argument("Error: incorrect SLAE matrix");
+  }
+  lu_ = std::move(matrix);
+  n_ = n;
+  decompose();
+}
+
+void LuSolver::factorize(const double* matrix, size_t n) {
+  lu_.assign(matrix, matrix + n * n);
+  n_ = n;
+  decompose();
+}
+
+void LuSolver::decompose() {
+  pivot_.resize(n_);
+  singular_ = false;
+  if (block_ > 0 && n_ > block_) {
+    decomposeBlocked();
+  } else {
+    factorizePanel(0, n_);
+  }
+}
+
+void LuSolver::decomposeBlocked() {
+  for (size_t first = 0; first < n_; first += block_) {
+    const size_t width = std::min(block_, n_ - first);
+    factorizePanel(first, width);
+    if (first + width < n_) {
+      updateTrailing(first, width);
+    }
+  }
+}
+
+// Right-looking elimination of columns [first, first + width), updating
+// only those columns. pivot_[k] is the row swapped with row k at step k;
+// the swap is applied to the whole row, multipliers included
+void LuSolver::factorizePanel(size_t first, size_t width) {
+  const size_t last = first + width;
+  for (size_t k = first; k < last; ++k) {
+    size_t p = k;
+    double max = std::fabs(lu_[k * n_ + k]);
+    for (size_t i = k + 1; i < n_; ++i) {
+      double value = std::fabs(lu_[i * n_ + k]);
+      if (value > max) {
+        max = value;
+        p = i;
+      }
+    }
+    pivot_[k] = p;
+    if (!(max > 0)) {
+      singular_ = true;
+      continue;
+    }
+    if (p != k) {
+      std::swap_ranges(lu_.begin() + k * n_, lu_.begin() + (k + 1) * n_,
+                       lu_.begin() + p * n_);
+    }
+    const double* pivot_row = lu_.data() + k * n_;
+    const double inv = 1.0 / pivot_row[k];
+    for (size_t i = k + 1; i < n_; ++i) {
+      double* row = lu_.data() + i * n_;
+      const double factor = row[k] * inv;
+      row[k] = factor;
+      for (size_t j = k + 1; j < last; ++j) {
+        row[j] -= factor * pivot_row[j];
+      }
+    }
+  }
+}
+
+// U12 = L11^-1 * A12 on the panel rows, then A22 -= L21 * U12 by tiles of
+// kTileRows rows, one task each
+void LuSolver::updateTrailing(size_t first, size_t width) {
+  const size_t last = first + width;
+  for (size_t k = first; k < last; ++k) {
+    const double* pivot_row = lu_.data() + k * n_;
+    for (size_t i = k + 1; i < last; ++i) {
+      double* row = lu_.data() + i * n_;
+      const double factor = row[k];
+      for (size_t j = last; j < n_; ++j) {
+        row[j] -= factor * pivot_row[j];
+      }
+    }
+  }
+  const size_t tiles = (n_ - last + kTileRows - 1) / kTileRows;
+  auto job = [this, first, width, last](size_t begin, size_t end) {
+    for (size_t tile = begin; tile < end; ++tile) {
+      const size_t row = last + tile * kTileRows;
+      updateTile(first, width, row, std::min(kTileRows, n_ - row));
+    }
+  };
+  if (pool_) {
+    pool_->parallelFor(0, tiles, 1, job);
+  } else {
+    job(0, tiles);
+  }
+}
+
+// Rows [row, row + rows) of the trailing matrix, kTileCols columns at a
+// time so the U12 block stays in cache, kKernel x kKernel results kept in
+// registers over the whole panel width
+void LuSolver::updateTile(size_t first, size_t width, size_t row,
+                          size_t rows) {
+  const size_t last = first + width;
+  const double* u = lu_.data() + first * n_;
+  for (size_t col = last; col < n_; col += kTileCols) {
+    const size_t cols = std::min(kTileCols, n_ - col);
+    size_t i = row;
+    for (; i + kKernel <= row + rows; i += kKernel) {
+      const double* l = lu_.data() + i * n_ + first;
+      size_t j = col;
+      for (; j + kKernel <= col + cols; j += kKernel) {
+        double acc[kKernel][kKernel]{};
+        for (size_t p = 0; p < width; ++p) {
+          const double* b = u + p * n_ + j;
+          for (size_t r = 0; r < kKernel; ++r) {
+            const double a = l[r * n_ + p];
+            for (size_t q = 0; q < kKernel; ++q) {
+              acc[r][q] += a * b[q];
+            }
+          }
+        }
+        for (size_t r = 0; r < kKernel; ++r) {
+          double* c = lu_.data() + (i + r) * n_ + j;
+          for (size_t q = 0; q < kKernel; ++q) {
+            c[q] -= acc[r][q];
+          }
+        }
+      }
+      for (; j < col + cols; ++j) {
+        for (size_t r = 0; r < kKernel; ++r) {
+          double sum = 0;
+          for (size_t p = 0; p < width; ++p) {
+            sum += l[r * n_ + p] * u[p * n_ + j];
+          }
+          lu_[(i + r) * n_ + j] -= sum;
+        }
+      }
+    }
+    for (; i < row + rows; ++i) {
+      const double* l = lu_.data() + i * n_ + first;
+      for (size_t j = col; j < col + cols; ++j) {
+        double sum = 0;
+        for (size_t p = 0; p < width; ++p) {
+          sum += l[p] * u[p * n_ + j];
+        }
+        lu_[i * n_ + j] -= sum;
+      }
+    }
+  }
+}
+
+void LuSolver::solve(const double* b, double* x) const {
+  if (x != b) {
+    std::copy(b, b + n_, x);
+  }
+  for (size_t k = 0; k < n_; ++k) {
+    if (pivot_[k] != k) {
+      std::swap(x[k], x[pivot_[k]]);
+    }
+  }
+  for (size_t i = 1; i < n_; ++i) {
+    const double* row = lu_.data() + i * n_;
+    double sum = x[i];
+    for (size_t j = 0; j < i; ++j) {
+      sum -= row[j] * x[j];
+    }
+    x[i] = sum;
+  }
+  for (size_t i = n_; i-- > 0;) {
+    const double* row = lu_.data() + i * n_;
+    double sum = x[i];
+    for (size_t j = i + 1; j < n_; ++j) {
+      sum -= row[j] * x[j];
+    }
+    x[i] = sum / row[i];
+  }
+}
+
+void LuSolver::solve(std::vector<double>& b) const {
+  if (b.size() != n_) {
+    throw std::invalid_argument("Error: incorrect SLAE matrix");
+  }
+  solve(b.data(), b.data());
+}
+
+}  //   namespace s21
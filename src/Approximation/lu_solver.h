@@ -0,0 +1,69 @@
+#ifndef SRC_APPROXIMATION_LU_SOLVER_H_
+#define SRC_APPROXIMATION_LU_SOLVER_H_
+
+//
+// LU factorization with partial pivoting, P * A = L * U, kept in one
+// row-major block: U on and above the diagonal, the multipliers of L
+// (unit diagonal) below it. Factorize once, then solve for any number of
+// right-hand sides in O(n^2) each.
+// With a block size set, large matrices are factorized right-looking by
+// panels of that many columns: the panel is eliminated column by column,
+// the rest of its rows is solved against the unit lower triangle, and the
+// trailing matrix gets one rank-block update in register-blocked tiles,
+// spread over a ThreadPool when one is given.
+//
+
+#include <stdexcept>
+#include <vector>
+
+#include "../ThreadPool/thread_pool.h"
+#include "../types.h"
+
+namespace s21 {
+
+class LuSolver {
+ public:
+  LuSolver() {}
+  ~LuSolver() = default;
+
+  // Uses the first rows() columns of every row, so an augmented matrix
+  // [A | b] can be passed as is
+  auto factorize(const Matrix& matrix) -> void;
+  // Takes over an n x n row-major block and factorizes it in place
+  auto factorize(std::vector<double>&& matrix, size_t n) -> void;
+  // Copies an n x n row-major block into the storage of the previous one
+  auto factorize(const double* matrix, size_t n) -> void;
+
+  // x = A^-1 * b; b and x may be the same array
+  auto solve(const double* b, double* x) const -> void;
+  auto solve(std::vector<double>& b) const -> void;
+
+  // 0 keeps the plain elimination
+  auto setBlockSize(size_t block) -> void { block_ = block; }
+  // nullptr updates the tiles on the calling thread
+  auto setThreadPool(ThreadPool* pool) -> void { pool_ = pool; }
+
+  auto size() const -> size_t { return n_; }
+  auto isSingular() const -> bool { return singular_; }
+  auto getData() const -> const std::vector<double>& { return lu_; }
+  auto getPivot() const -> const std::vector<size_t>& { return pivot_; }
+
+ private:
+  auto decompose() -> void;
+  auto decomposeBlocked() -> void;
+  auto factorizePanel(size_t first, size_t width) -> void;
+  auto updateTrailing(size_t first, size_t width) -> void;
+  auto updateTile(size_t first, size_t width, size_t row, size_t rows)
+      -> void;
+
+  std::vector<double> lu_{};
+  std::vector<size_t> pivot_{};
+  size_t n_{0};
+  size_t block_{0};
+  ThreadPool* pool_{nullptr};
+  bool singular_{false};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_APPROXIMATION_LU_SOLVER_H_
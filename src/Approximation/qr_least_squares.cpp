@@ -0,0 +1,81 @@
+#include "qr_least_squares.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace s21 {
+
+void QrLeastSquares::reset(size_t cols) {
+  n_ = cols;
+  r_.assign(n_ * n_, 0);
+  qty_.assign(n_, 0);
+  residual_ = 0;
+}
+
+// Column k of [R; A] is R(k, k) over A(:, k), R being zero below the
+// diagonal; the reflection v = [R(k, k) - alpha; A(:, k)] zeroes A(:, k)
+// and leaves alpha in R(k, k)
+void QrLeastSquares::addRows(double* a, double* y, size_t rows) {
+  for (size_t k = 0; k < n_; ++k) {
+    double* v = a + k * rows;
+    double* rk = r_.data() + k * n_;
+    double tail = 0;
+    for (size_t i = 0; i < rows; ++i) {
+      tail += v[i] * v[i];
+    }
+    if (tail == 0) continue;
+    const double norm = std::sqrt(rk[k] * rk[k] + tail);
+    const double alpha = rk[k] > 0 ? -norm : norm;
+    const double v0 = rk[k] - alpha;
+    const double beta = 1.0 / (norm * (norm + std::fabs(rk[k])));
+    rk[k] = alpha;
+    for (size_t j = k + 1; j < n_; ++j) {
+      double* col = a + j * rows;
+      double s = v0 * rk[j];
+      for (size_t i = 0; i < rows; ++i) {
+        s += v[i] * col[i];
+      }
+      s *= beta;
+      rk[j] -= s * v0;
+      for (size_t i = 0; i < rows; ++i) {
+        col[i] -= s * v[i];
+      }
+    }
+    double s = v0 * qty_[k];
+    for (size_t i = 0; i < rows; ++i) {
+      s += v[i] * y[i];
+    }
+    s *= beta;
+    qty_[k] -= s * v0;
+    for (size_t i = 0; i < rows; ++i) {
+      y[i] -= s * v[i];
+    }
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    residual_ += y[i] * y[i];
+  }
+}
+
+bool QrLeastSquares::solve(double* x) const {
+  double max = 0;
+  for (size_t k = 0; k < n_; ++k) {
+    max = std::max(max, std::fabs(r_[k * n_ + k]));
+  }
+  const double tolerance =
+      max * n_ * std::numeric_limits<double>::epsilon();
+  for (size_t k = 0; k < n_; ++k) {
+    if (!(std::fabs(r_[k * n_ + k]) > tolerance)) return false;
+  }
+  for (size_t i = n_; i-- > 0;) {
+    const double* row = r_.data() + i * n_;
+    double sum = qty_[i];
+    for (size_t j = i + 1; j < n_; ++j) {
+      sum -= row[j] * x[j];
+    }
+    x[i] = sum / row[i];
+  }
+  return true;
+}
+
+}  //   namespace s21
@@ -0,0 +1,44 @@
+#ifndef SRC_APPROXIMATION_QR_LEAST_SQUARES_H_
+#define SRC_APPROXIMATION_QR_LEAST_SQUARES_H_
+
+//
+// Least squares min |A * x - y| by Householder QR, fed a block of rows at
+// a time. Only the n x n triangle R and Q^T * y are kept: every block is
+// stacked under R and reduced back to a triangle by n reflections that
+// touch R's pivot row and the block, so memory stays O(rows * n) however
+// many rows are streamed in. Never forms A^T * A, so the conditioning is
+// that of A, not its square.
+//
+
+#include <cstddef>
+#include <vector>
+
+namespace s21 {
+
+class QrLeastSquares {
+ public:
+  QrLeastSquares() {}
+  ~QrLeastSquares() = default;
+
+  // Starts a new problem with cols unknowns
+  auto reset(size_t cols) -> void;
+  // a holds rows x cols() values column by column (a[j * rows + i]), y
+  // the rows targets; both are used as scratch
+  auto addRows(double* a, double* y, size_t rows) -> void;
+  // x gets cols() values; false if R is numerically rank deficient
+  auto solve(double* x) const -> bool;
+
+  auto cols() const -> size_t { return n_; }
+  // Sum of squared residuals of the rows added so far
+  auto residual() const -> double { return residual_; }
+
+ private:
+  std::vector<double> r_{};
+  std::vector<double> qty_{};
+  size_t n_{0};
+  double residual_{0};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_APPROXIMATION_QR_LEAST_SQUARES_H_
@@ -0,0 +1,99 @@
+#include "rolling_regression.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "approximation_accumulator.h"
+#include "batch_solver.h"
+
+namespace s21 {
+
+namespace {
+
+// Windows whose normal equations are solved by one solveBatch() call
+constexpr size_t kSolveBatch = 8 * kBatchLanes;
+
+}  //   namespace
+
+RollingRegression::RollingRegression(int degree, size_t window,
+                                     size_t horizon)
+    : degree_(degree), window_(window), horizon_(horizon) {
+  if (degree < 0 || window < static_cast<size_t>(degree) + 1) {
+    throw std::invalid_argument("Error: window too short for the degree");
+  }
+}
+
+void RollingRegression::forecast(const TimeSeries& data,
+                                 std::vector<double>& out) const {
+  const size_t reach = window_ + horizon_;
+  if (data.size() <= reach) {
+    out.clear();
+    return;
+  }
+  const size_t count = data.size() - reach;
+  out.resize(count);
+  // x = (t - window start) * scale stays within [0, 1] over a window of
+  // average spacing
+  const double span = static_cast<double>(data.time.back() -
+                                          data.time.front()) *
+                      (window_ - 1) / (data.size() - 1);
+  const double scale = span > 0 ? 1.0 / span : 1.0;
+  if (!pool_) {
+    forecastRange(data, scale, 0, count, out.data());
+    return;
+  }
+  const size_t grain =
+      std::max(window_, (count + 4 * pool_->size() - 1) / (4 * pool_->size()));
+  pool_->parallelFor(0, count, grain,
+                     [this, &data, scale, &out](size_t begin, size_t end) {
+                       forecastRange(data, scale, begin, end, out.data());
+                     });
+}
+
+void RollingRegression::forecastRange(const TimeSeries& data, double scale,
+                                      size_t begin, size_t end,
+                                      double* out) const {
+  const size_t n = degree_ + 1;
+  auto time = [&data](size_t i) { return static_cast<double>(data.time[i]); };
+  ApproximationAccumulator acc(degree_, time(begin), scale);
+  std::vector<double> slae(kSolveBatch * n * n), rhs(kSolveBatch * n);
+  size_t slides = 0;
+  for (size_t first = begin; first < end; first += kSolveBatch) {
+    const size_t batch = std::min(kSolveBatch, end - first);
+    for (size_t w = 0; w < batch; ++w) {
+      const size_t i = first + w;
+      if (i == begin || ++slides == window_) {
+        slides = 0;
+        acc.clear();
+        acc.setOrigin(time(i));
+        for (size_t j = i; j < i + window_; ++j) {
+          acc.add(time(j), data.value[j]);
+        }
+      } else {
+        acc.remove(time(i - 1), data.value[i - 1]);
+        acc.add(time(i + window_ - 1), data.value[i + window_ - 1]);
+        acc.setOrigin(time(i));
+      }
+      const std::vector<double>& sums = acc.getPowerSums();
+      double* a = slae.data() + w * n * n;
+      for (size_t r = 0; r < n; ++r) {
+        for (size_t c = 0; c < n; ++c) a[r * n + c] = sums[r + c];
+      }
+      std::copy(acc.getMoments().begin(), acc.getMoments().end(),
+                rhs.begin() + w * n);
+    }
+    solveBatch(slae.data(), rhs.data(), rhs.data(), n, batch);
+    for (size_t w = 0; w < batch; ++w) {
+      const size_t i = first + w;
+      const double x = (time(i + window_ + horizon_) - time(i)) * scale;
+      const double* coeff = rhs.data() + w * n;
+      double result = coeff[n - 1];
+      for (size_t k = n - 1; k-- > 0;) {
+        result = result * x + coeff[k];
+      }
+      out[i] = result;
+    }
+  }
+}
+
+}  //   namespace s21
@@ -0,0 +1,49 @@
+#ifndef SRC_APPROXIMATION_ROLLING_REGRESSION_H_
+#define SRC_APPROXIMATION_ROLLING_REGRESSION_H_
+
+//
+// Least squares fit on every window of a series for forecast backtests.
+// An ApproximationAccumulator slides along the series: one point in, one
+// out and a move of the origin to the window start, O(degree^2) per slide
+// instead of a refit over the window. The sums are rebuilt from the
+// window every window slides so the add/drop rounding does not pile up.
+// The normal equations of consecutive windows go to solveBatch() together.
+// Disjoint ranges of windows run on a ThreadPool when one is given.
+//
+
+#include <vector>
+
+#include "../ThreadPool/thread_pool.h"
+#include "../types.h"
+
+namespace s21 {
+
+class RollingRegression {
+ public:
+  // window points per fit, horizon points past the one right after the
+  // window (0: one step ahead)
+  RollingRegression(int degree, size_t window, size_t horizon = 0);
+  ~RollingRegression() = default;
+
+  // nullptr fits on the calling thread
+  auto setThreadPool(ThreadPool* pool) -> void { pool_ = pool; }
+
+  // out[i]: the fit over points [i, i + window) at the time of point
+  // i + window + horizon, so out[i] forecasts value[i + window + horizon];
+  // size() - window - horizon values, NaN where a window fit is singular
+  auto forecast(const TimeSeries& data, std::vector<double>& out) const
+      -> void;
+
+ private:
+  auto forecastRange(const TimeSeries& data, double scale, size_t begin,
+                     size_t end, double* out) const -> void;
+
+  int degree_;
+  size_t window_;
+  size_t horizon_;
+  ThreadPool* pool_{nullptr};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_APPROXIMATION_ROLLING_REGRESSION_H_
@@ -0,0 +1,117 @@
+#include "barycentric_interpolation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+void BarycentricInterpolation::initBarycentricPolynomial(
+    const std::vector<Point>& points) {
+  clear();
+  for (auto& it : points) {
+    addNode(it);
+  }
+}
+
+void BarycentricInterpolation::initBarycentricPolynomial(
+    const TimeSeries& data_points) {
+  clear();
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    addNode({static_cast<double>(data_points.time[i]), data_points.value[i]});
+  }
+}
+
+// The new node divides every weight by (x(i) - x). Its own weight
+// 1 / prod(x - x(i)) is accumulated as mantissa and binary exponent, so it
+// can be brought to the scale of the others without overflow
+void BarycentricInterpolation::addNode(const Point& point) {
+  const size_t size = nodes_.size();
+  double mantissa = 1.0;
+  int exponent = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const double diff = nodes_[i] - point.first;
+    if (diff == 0) {
+      throw std::invalid_argument("Error: duplicate interpolation node");
+    }
+    weights_[i] /= diff;
+    int shift = 0;
+    mantissa = std::frexp(mantissa / -diff, &shift);
+    exponent += shift;
+  }
+  weights_.push_back(std::ldexp(mantissa, exponent - exponent_));
+  nodes_.push_back(point.first);
+  values_.push_back(point.second);
+
+  double max = 0;
+  for (double w : weights_) {
+    max = std::max(max, std::fabs(w));
+  }
+  const int scale = std::ilogb(max);
+  exponent_ += scale;
+  scaled_.resize(size + 1);
+  for (size_t i = 0; i <= size; ++i) {
+    weights_[i] = std::ldexp(weights_[i], -scale);
+    scaled_[i] = weights_[i] * values_[i];
+  }
+}
+
+std::vector<double>& BarycentricInterpolation::getCoeff() { return weights_; }
+
+double BarycentricInterpolation::getValue(double t) {
+  if (weights_.empty()) {
+    throw std::domain_error("Error: Barycentric polynomial not inited");
+  }
+  double num = 0, den = 0;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const double r = 1.0 / (t - nodes_[i]);
+    num += scaled_[i] * r;
+    den += weights_[i] * r;
+  }
+  const double value = num / den;
+  return std::isfinite(value) ? value : nodeValue(t);
+}
+
+// Node-major sweep over a block of arguments: the inner loop has no branch
+// and no dependency between lanes. A lane sitting exactly on a node comes
+// out as inf / inf and is patched afterwards
+void BarycentricInterpolation::evaluate(const double* t, double* out,
+                                        size_t count) {
+  if (weights_.empty()) {
+    throw std::domain_error("Error: Barycentric polynomial not inited");
+  }
+  double x[kEvalBlock], num[kEvalBlock], den[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    std::fill(x + block, x + kEvalBlock, nodes_[0] + 1.0);
+    std::copy(t + first, t + first + block, x);
+    std::fill(num, num + kEvalBlock, 0.0);
+    std::fill(den, den + kEvalBlock, 0.0);
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      const double node = nodes_[i], w = weights_[i], wy = scaled_[i];
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        const double r = 1.0 / (x[j] - node);
+        num[j] += wy * r;
+        den[j] += w * r;
+      }
+    }
+    for (size_t j = 0; j < block; ++j) {
+      const double value = num[j] / den[j];
+      out[first + j] = std::isfinite(value) ? value : nodeValue(x[j]);
+    }
+  }
+}
+
+void BarycentricInterpolation::clear() {
+  weights_.clear();
+  scaled_.clear();
+  nodes_.clear();
+  values_.clear();
+  exponent_ = 0;
+}
+
+double BarycentricInterpolation::nodeValue(double t) {
+  auto it = std::find(nodes_.begin(), nodes_.end(), t);
+  return it == nodes_.end() ? NAN : values_[it - nodes_.begin()];
+}
+
+}  //   namespace s21
@@ -0,0 +1,50 @@
+#ifndef SRC_BARYCENTRICINTERPOLATION_BARYCENTRIC_INTERPOLATION_H_
+#define SRC_BARYCENTRICINTERPOLATION_BARYCENTRIC_INTERPOLATION_H_
+
+//
+// Interpolation polynomial in the second barycentric form
+//   P(t) = sum(w(i) * y(i) / (t - x(i))) / sum(w(i) / (t - x(i)))
+// with w(i) = 1 / prod(x(i) - x(j), j != i). The weights are rescaled to
+// max |w| = 1 after every node, which the quotient does not see but which
+// keeps them finite at high degree and on epoch-second abscissas.
+//
+
+#include <stdexcept>
+#include <vector>
+
+#include "../types.h"
+
+namespace s21 {
+
+class BarycentricInterpolation {
+ public:
+  BarycentricInterpolation() {}
+  ~BarycentricInterpolation() = default;
+  BarycentricInterpolation(const BarycentricInterpolation&) = delete;
+  BarycentricInterpolation(BarycentricInterpolation&&) = delete;
+  void operator=(const BarycentricInterpolation&) = delete;
+  void operator=(BarycentricInterpolation&&) = delete;
+
+  auto initBarycentricPolynomial(const std::vector<Point>&) -> void;
+  auto initBarycentricPolynomial(const TimeSeries&) -> void;
+  auto addNode(const Point& point) -> void;
+
+  // Barycentric weights, one per node
+  auto getCoeff() -> std::vector<double>&;
+  auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+ private:
+  auto clear() -> void;
+  auto nodeValue(double t) -> double;
+
+  std::vector<double> weights_{};
+  std::vector<double> scaled_{};
+  std::vector<double> nodes_{};
+  std::vector<double> values_{};
+  int exponent_{0};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_BARYCENTRICINTERPOLATION_BARYCENTRIC_INTERPOLATION_H_
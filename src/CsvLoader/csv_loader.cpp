@@ -0,0 +1,312 @@
+#include "csv_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+namespace s21 {
+
+namespace {
+
+// Maps the file; small files are read instead, since setting up and tearing
+// down a mapping costs more than copying a few pages
+class MappedFile {
+ public:
+  static constexpr size_t kMinMappedSize = 64 * 1024;
+
+  explicit MappedFile(const std::string& fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::invalid_argument("Error: can't open the " + fileName);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::invalid_argument("Error: can't open the " + fileName);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0 && size_ < kMinMappedSize) {
+      copy_.resize(size_);
+      size_t done = 0;
+      while (done < size_) {
+        ssize_t got = ::read(fd, copy_.data() + done, size_ - done);
+        if (got <= 0) {
+          ::close(fd);
+          throw std::invalid_argument("Error: can't open the " + fileName);
+        }
+        done += static_cast<size_t>(got);
+      }
+      data_ = copy_.data();
+    } else if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::invalid_argument("Error: can't open the " + fileName);
+      }
+      ::madvise(addr, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+  }
+  ~MappedFile() {
+    if (data_ && copy_.empty()) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  void operator=(const MappedFile&) = delete;
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_{nullptr};
+  size_t size_{0};
+  std::vector<char> copy_;
+};
+
+constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                             1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                             1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr unsigned long long kMaxExactMantissa = 1ULL << 53;
+
+inline bool isDigit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+
+// Days since 1970-01-01 of the proleptic Gregorian date (H. Hinnant)
+long long daysFromCivil(long long y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+// Row count upper bound, used to size the output in one allocation
+size_t countLines(const char* begin, const char* end) {
+  size_t count = 1;
+  while ((begin = static_cast<const char*>(
+              std::memchr(begin, '\n', end - begin))) != nullptr) {
+    ++count;
+    ++begin;
+  }
+  return count;
+}
+
+// Splits non-empty sorted times into runs of equal key(time) and calls
+// apply(first, last, key) for each. The key is sampled every `step` seconds
+// and bisected only between samples that differ, so it is assumed to change
+// at most once per step.
+template <typename Key, typename Apply>
+void forEachRun(std::int64_t* begin, std::int64_t* end, std::int64_t step,
+                Key key, Apply apply) {
+  std::int64_t* run = begin;
+  std::int64_t* known = begin;  // last time known to share run_key
+  auto run_key = key(*run);
+  while (known + 1 != end) {
+    std::int64_t* probe =
+        std::lower_bound(known + 1, end, *known + step) - 1;
+    if (probe == known) probe = known + 1;
+    auto probe_key = key(*probe);
+    if (probe_key == run_key) {
+      known = probe;
+      continue;
+    }
+    while (probe - known > 1) {
+      std::int64_t* mid = known + (probe - known) / 2;
+      auto mid_key = key(*mid);
+      if (mid_key == run_key) {
+        known = mid;
+      } else {
+        probe = mid;
+        probe_key = mid_key;
+      }
+    }
+    apply(run, probe, run_key);
+    run = known = probe;
+    run_key = probe_key;
+  }
+  apply(run, end, run_key);
+}
+
+}  //   namespace
+
+void CsvLoader::loadFromFile(const std::string& fileName,
+                             TimeSeries& series) {
+  MappedFile file(fileName);
+  loadFromBuffer(file.data(), file.size(), series);
+}
+
+void CsvLoader::loadFromBuffer(const char* data, size_t size,
+                               TimeSeries& series) {
+  const char* end = data + size;
+  const char* eol =
+      size ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+  if (!eol) eol = end;
+  const char* last = eol;
+  if (last > data && last[-1] == '\r') --last;
+  if (static_cast<size_t>(last - data) != kPrefix.size() ||
+      std::memcmp(data, kPrefix.data(), kPrefix.size()) != 0) {
+    throw std::out_of_range("Error: incorrect header");
+  }
+
+  const char* cur = eol == end ? end : eol + 1;
+  const size_t first = series.size();
+  series.reserve(first + countLines(cur, end));
+  std::int64_t time{0};
+  double value{0};
+  while (cur < end) {
+    eol = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+    if (!eol) eol = end;
+    last = eol;
+    if (last > cur && last[-1] == '\r') --last;
+    if (last > cur) {
+      if (!parseRow(cur, last, time, value)) {
+        throw std::out_of_range("Error: incorrect format");
+      }
+      series.push_back(time, value);
+    }
+    cur = eol + 1;
+  }
+  toLocalTime(series.time.data() + first,
+              series.time.data() + series.time.size());
+}
+
+bool CsvLoader::parseRow(const char* begin, const char* end,
+                         std::int64_t& time, double& value) {
+  const char* comma =
+      static_cast<const char*>(std::memchr(begin, ',', end - begin));
+  return comma && parseDate(begin, comma, time) &&
+         parseValue(comma + 1, end, value);
+}
+
+bool CsvLoader::parseDate(const char* begin, const char* end,
+                          std::int64_t& time) {
+  int field[3]{0, 0, 0};
+  for (int i = 0; i < 3; ++i) {
+    const char* start = begin;
+    while (begin < end && isDigit(*begin)) {
+      field[i] = field[i] * 10 + (*begin++ - '0');
+    }
+    if (begin == start || begin - start > (i ? 2 : 4)) return false;
+    if (i < 2 && (begin == end || *begin++ != '-')) return false;
+  }
+  if (begin != end || field[1] < 1 || field[1] > 12 || field[2] < 1 ||
+      field[2] > 31) {
+    return false;
+  }
+  time = daysFromCivil(field[0], field[1], field[2]) * kSecInDay;
+  return true;
+}
+
+// Dates are parsed as UTC midnights; shift them to the local midnight that
+// std::mktime() gives (tm_isdst = 0). std::mktime() re-reads the zone on every
+// call, so for sorted times the zone state is sampled weekly with the cheap
+// localtime_r() and std::mktime() only checks the ends of each state's run:
+// inside a run just its first or last date can still fall on the other side
+// of a transition. Unsorted times fall back to one lookup per distinct date.
+void CsvLoader::toLocalTime(std::int64_t* begin, std::int64_t* end) {
+  constexpr std::int64_t kStep = 7 * kSecInDay;
+  auto offset = [](std::int64_t utc) -> std::int64_t {
+    std::time_t t = static_cast<std::time_t>(utc);
+    std::tm date{};
+    gmtime_r(&t, &date);
+    date.tm_isdst = 0;
+    return static_cast<std::int64_t>(std::mktime(&date)) - utc;
+  };
+  if (begin == end) return;
+  if (!std::is_sorted(begin, end)) {
+    std::unordered_map<std::int64_t, std::int64_t> offsets;
+    for (; begin != end; ++begin) {
+      auto it = offsets.find(*begin);
+      if (it == offsets.end()) {
+        it = offsets.emplace(*begin, offset(*begin)).first;
+      }
+      *begin += it->second;
+    }
+    return;
+  }
+
+  auto state = [](std::int64_t utc) -> std::pair<long, int> {
+    std::time_t t = static_cast<std::time_t>(utc);
+    std::tm date{};
+    localtime_r(&t, &date);
+    return {date.tm_gmtoff, date.tm_isdst};
+  };
+  auto shift = [](std::int64_t* first, std::int64_t* last,
+                  std::int64_t value) {
+    for (; first != last; ++first) *first += value;
+  };
+  forEachRun(begin, end, kStep, state,
+             [&offset, &shift](std::int64_t* first, std::int64_t* last,
+                               std::pair<long, int>) {
+               forEachRun(first, last, last[-1] - *first + 1, offset, shift);
+             });
+}
+
+bool CsvLoader::parseValue(const char* begin, const char* end,
+                           double& value) {
+  const char* p = begin;
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+  unsigned long long mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool exact = true;
+  const char* first_digit = p;
+  for (; p < end && isDigit(*p); ++p) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits += mantissa != 0;
+    } else {
+      ++exponent;
+      exact = false;
+    }
+  }
+  bool has_digits = p != first_digit;
+  if (p < end && *p == '.') {
+    const char* frac = ++p;
+    for (; p < end && isDigit(*p); ++p) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa != 0;
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+    has_digits = has_digits || p != frac;
+  }
+  if (has_digits && p < end && (*p == 'e' || *p == 'E')) exact = false;
+
+  if (has_digits && exact && mantissa <= kMaxExactMantissa &&
+      exponent >= -22 && exponent <= 22) {
+    double result = static_cast<double>(mantissa);
+    result = exponent < 0 ? result / kPow10[-exponent]
+                          : result * kPow10[exponent];
+    value = negative ? -result : result;
+    return true;
+  }
+
+  // Slow path: exponents, long mantissas, inf/nan - same rules as std::stod.
+  // Mantissas above 2^53 (full 16-17 digit doubles such as sin.csv) can't be
+  // rounded exactly with one division, so they land here too.
+  char buffer[128];
+  size_t length =
+      std::min(static_cast<size_t>(end - begin), sizeof(buffer) - 1);
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+  char* parsed = nullptr;
+  value = std::strtod(buffer, &parsed);
+  return parsed != buffer;
+}
+
+}  //   namespace s21
@@ -0,0 +1,43 @@
+#ifndef SRC_CSVLOADER_CSV_LOADER_H_
+#define SRC_CSVLOADER_CSV_LOADER_H_
+
+//
+// Single pass "Date,Close" reader over a memory mapped file.
+// Dates are parsed by hand (YYYY-MM-DD) straight into epoch seconds,
+// prices take the exact Clinger fast path and fall back to strtod()
+// only for the rare inputs it can not represent exactly.
+//
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../types.h"
+
+namespace s21 {
+
+class CsvLoader {
+ public:
+  CsvLoader() {}
+  ~CsvLoader() = default;
+  CsvLoader(const CsvLoader&) = delete;
+  CsvLoader(CsvLoader&&) = delete;
+  void operator=(const CsvLoader&) = delete;
+  void operator=(CsvLoader&&) = delete;
+
+  auto loadFromFile(const std::string& filename, TimeSeries&) -> void;
+  auto loadFromBuffer(const char* data, size_t size, TimeSeries&) -> void;
+
+ private:
+  auto parseRow(const char* begin, const char* end, std::int64_t& time,
+                double& value) -> bool;
+  auto parseDate(const char* begin, const char* end, std::int64_t& time)
+      -> bool;
+  auto parseValue(const char* begin, const char* end, double& value) -> bool;
+  auto toLocalTime(std::int64_t* begin, std::int64_t* end) -> void;
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_CSVLOADER_CSV_LOADER_H_
@@ -0,0 +1,170 @@
+#include "hermite_interpolation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+// Knots per block of the parallel build
+constexpr size_t kHermiteGrain = 1 << 14;
+
+auto sign(double x) -> int { return (x > 0) - (x < 0); }
+
+}  //   namespace
+
+void HermiteInterpolation::resetLookup() {
+  lookup_.init(std::vector<double>(x_));
+}
+
+void HermiteInterpolation::initHermiteSpline(const std::vector<Point>& points) {
+  x_.resize(points.size());
+  y_.resize(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    x_[i] = points[i].first;
+    y_[i] = points[i].second;
+  }
+  resetLookup();
+  calculateCoeff();
+}
+
+void HermiteInterpolation::initHermiteSpline(const TimeSeries& data_points) {
+  x_.resize(data_points.size());
+  y_.resize(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    x_[i] = static_cast<double>(data_points.time[i]);
+    y_[i] = data_points.value[i];
+  }
+  resetLookup();
+  calculateCoeff();
+}
+
+void HermiteInterpolation::appendPoint(const Point& point) {
+  if (!x_.empty() && !(point.first > x_.back())) {
+    throw std::invalid_argument(
+        "Error: appended point must be later than the last knot");
+  }
+  x_.push_back(point.first);
+  y_.push_back(point.second);
+  lookup_.push_back(point.first);
+  const size_t size = x_.size();
+  if (size < 4) {
+    calculateCoeff();
+    return;
+  }
+  // The former end slope becomes an interior one; the first end slope
+  // only sees the first three knots
+  coeff_.push_back(SplineSegment{0, 0, 0, 0});
+  slope_.push_back(0);
+  updateSlopes(size - 2, size);
+  updateSegments(size - 2, size);
+}
+
+void HermiteInterpolation::appendPoints(const std::vector<Point>& points) {
+  for (auto& it : points) {
+    appendPoint(it);
+  }
+}
+
+SplineCoeffView HermiteInterpolation::getCoeff() const {
+  return segmentView(coeff_);
+}
+
+double HermiteInterpolation::getValue(double t) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Hermite spline not inited");
+  }
+  return evaluateSegments(coeff_.data(), lookup_, t);
+}
+
+void HermiteInterpolation::evaluate(const double* t, double* out,
+                                    size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Hermite spline not inited");
+  }
+  evaluateSegments(coeff_.data(), lookup_, t, out, count);
+}
+
+void HermiteInterpolation::calculateCoeff() {
+  const size_t size = x_.size();
+  coeff_.assign(size, SplineSegment{0, 0, 0, 0});
+  slope_.assign(size, 0);
+  if (size == 1) {
+    coeff_[0].a = y_[0];
+  }
+  if (size < 2) {
+    return;
+  }
+  pool_->parallelFor(0, size, kHermiteGrain, [this](size_t begin, size_t end) {
+    updateSlopes(begin, end);
+  });
+  pool_->parallelFor(0, size, kHermiteGrain, [this](size_t begin, size_t end) {
+    updateSegments(begin, end);
+  });
+}
+
+// Three-point slope at an end knot over the intervals knot-inner and
+// inner-outer, clipped so the end segment stays monotone
+double HermiteInterpolation::endSlope(size_t knot, size_t inner,
+                                      size_t outer) const {
+  const double h0 = std::fabs(x_[inner] - x_[knot]);
+  const double d0 = (y_[inner] - y_[knot]) / (x_[inner] - x_[knot]);
+  if (outer >= x_.size()) {
+    return d0;
+  }
+  const double h1 = std::fabs(x_[outer] - x_[inner]);
+  const double d1 = (y_[outer] - y_[inner]) / (x_[outer] - x_[inner]);
+  double slope = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+  if (sign(slope) != sign(d0)) {
+    slope = 0;
+  } else if (sign(d0) != sign(d1) && std::fabs(slope) > 3.0 * std::fabs(d0)) {
+    slope = 3.0 * d0;
+  }
+  return slope;
+}
+
+// Slopes of knots first..last - 1. The interior loop has no branches
+// left, so it vectorizes
+void HermiteInterpolation::updateSlopes(size_t first, size_t last) {
+  const size_t size = x_.size();
+  if (first == 0) {
+    slope_[0] = endSlope(0, 1, 2);
+    ++first;
+  }
+  const bool right_end = last == size;
+  if (right_end) {
+    --last;
+  }
+  const double* x = x_.data();
+  const double* y = y_.data();
+  double* slope = slope_.data();
+  for (size_t i = first; i < last; ++i) {
+    const double h0 = x[i] - x[i - 1], h1 = x[i + 1] - x[i];
+    const double d0 = (y[i] - y[i - 1]) / h0, d1 = (y[i + 1] - y[i]) / h1;
+    const double w0 = 2.0 * h1 + h0, w1 = h1 + 2.0 * h0;
+    const double mean = (w0 + w1) * d0 * d1 / (w0 * d1 + w1 * d0);
+    slope[i] = d0 * d1 > 0 ? mean : 0.0;
+  }
+  if (right_end && size > 1) {
+    slope_[size - 1] = endSlope(size - 1, size - 2, size < 3 ? size : size - 3);
+  }
+}
+
+// Segments first..last - 1, each ending at its knot
+void HermiteInterpolation::updateSegments(size_t first, size_t last) {
+  if (first == 0) {
+    coeff_[0] = SplineSegment{y_[0], 0, 0, 0};
+    ++first;
+  }
+  for (size_t i = first; i < last; ++i) {
+    const double h = x_[i] - x_[i - 1];
+    const double secant = (y_[i] - y_[i - 1]) / h;
+    coeff_[i].a = y_[i];
+    coeff_[i].b = slope_[i];
+    coeff_[i].c = (2.0 * slope_[i] + slope_[i - 1] - 3.0 * secant) / h;
+    coeff_[i].d = (slope_[i] + slope_[i - 1] - 2.0 * secant) / (h * h);
+  }
+}
+
+}  //   namespace s21
@@ -0,0 +1,63 @@
+#ifndef SRC_HERMITEINTERPOLATION_HERMITE_INTERPOLATION_H_
+#define SRC_HERMITEINTERPOLATION_HERMITE_INTERPOLATION_H_
+
+//
+// Monotone piecewise cubic Hermite interpolation (PCHIP, Fritsch-Carlson).
+// The slope at a knot is the weighted harmonic mean of the secants next to
+// it, or 0 where they differ in sign, so the curve never overshoots the
+// data; the ends use the shape-preserving three-point formula. Slopes only
+// depend on the neighbouring knots: the build needs no system solve and
+// runs in independent blocks, and an append recomputes the last two
+// segments. Coefficients are stored like the cubic spline ones (see
+// spline_coeff.h, segments layout).
+//
+
+#include <stdexcept>
+#include <vector>
+
+#include "../SplineInterpolation/segment_lookup.h"
+#include "../SplineInterpolation/spline_coeff.h"
+#include "../ThreadPool/thread_pool.h"
+#include "../types.h"
+
+namespace s21 {
+
+class HermiteInterpolation {
+ public:
+  HermiteInterpolation() {}
+  ~HermiteInterpolation() = default;
+  HermiteInterpolation(const HermiteInterpolation&) = delete;
+  HermiteInterpolation(HermiteInterpolation&&) = delete;
+  void operator=(const HermiteInterpolation&) = delete;
+  void operator=(HermiteInterpolation&&) = delete;
+
+  auto initHermiteSpline(const std::vector<Point>&) -> void;
+  auto initHermiteSpline(const TimeSeries&) -> void;
+  // Identical to a full init with the point included
+  auto appendPoint(const Point& point) -> void;
+  auto appendPoints(const std::vector<Point>& points) -> void;
+
+  auto setThreadPool(ThreadPool& pool) -> void { pool_ = &pool; }
+
+  auto getCoeff() const -> SplineCoeffView;
+  auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+ private:
+  auto resetLookup() -> void;
+  auto calculateCoeff() -> void;
+  auto endSlope(size_t knot, size_t inner, size_t outer) const -> double;
+  auto updateSlopes(size_t first, size_t last) -> void;
+  auto updateSegments(size_t first, size_t last) -> void;
+
+  std::vector<double> x_{};
+  std::vector<double> y_{};
+  std::vector<double> slope_{};
+  std::vector<SplineSegment> coeff_{};
+  SegmentLookup lookup_{};
+  ThreadPool* pool_{&ThreadPool::GetInstance()};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_HERMITEINTERPOLATION_HERMITE_INTERPOLATION_H_
@@ -1,5 +1,7 @@
 #include "newton_interpolation.h"
 
+#include <algorithm>
+
 namespace s21 {
 
 void NewtonInterpolation::initNewtonPolynomial(
@@ -9,12 +11,13 @@ void NewtonInterpolation::initNewtonPolynomial(
   calculateCoeff();
 }
 
-void NewtonInterpolation::initNewtonPolynomial(
-    std::vector<DataPoint>& data_points_) {
+void NewtonInterpolation::initNewtonPolynomial(const TimeSeries& data_points) {
   coeff_.clear();
   points_.clear();
-  for (auto& it : data_points_) {
-    points_.push_back({std::mktime(&it.first), it.second});
+  points_.reserve(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    points_.push_back(
+        {static_cast<double>(data_points.time[i]), data_points.value[i]});
   }
   calculateCoeff();
 }
@@ -28,18 +31,160 @@ double NewtonInterpolation::getValue(double t) {
   return calculateValue(points_.size() - 1, t);
 }
 
+// Nested form c0 + (t - x0)(c1 + (t - x1)(c2 + ...)), one coefficient at a
+// time over a whole block of arguments
+void NewtonInterpolation::evaluate(const double* t, double* out,
+                                   size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Newton polynomial not inited");
+  }
+  const size_t degree = coeff_.size() - 1;
+  double x[kEvalBlock], value[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    std::fill(x + block, x + kEvalBlock, 0.0);
+    std::copy(t + first, t + first + block, x);
+    std::fill(value, value + kEvalBlock, coeff_[degree]);
+    for (size_t k = degree; k-- > 0;) {
+      const double node = points_[k].first, c = coeff_[k];
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        value[j] = value[j] * (x[j] - node) + c;
+      }
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
+// In-place divided differences: after pass j, coeff_[i] (i >= j) holds
+// f[x(i - j), ..., x(i)]. tail_ keeps the differences ending at the last
+// node, which is all addNode() needs
 void NewtonInterpolation::calculateCoeff() {
-  if (!points_.empty()) {
-    coeff_.push_back(points_[0].second);
-    for (size_t i = 1; i < points_.size(); ++i) {
-      double p = 1.0;
-      for (size_t j = 0; j < i; ++j) {
-        p *= points_[i].first - points_[j].first;
+  const size_t size = points_.size();
+  primitive_.clear();
+  coeff_.resize(size);
+  tail_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    coeff_[i] = points_[i].second;
+  }
+  if (size) {
+    tail_[0] = coeff_[size - 1];
+  }
+  for (size_t j = 1; j < size; ++j) {
+    for (size_t i = size - 1; i >= j; --i) {
+      coeff_[i] = (coeff_[i] - coeff_[i - 1]) /
+                  (points_[i].first - points_[i - j].first);
+    }
+    tail_[j] = coeff_[size - 1];
+  }
+}
+
+void NewtonInterpolation::addNode(const Point& point) {
+  const size_t size = points_.size();
+  double diff = point.second;
+  for (size_t j = 0; j < size; ++j) {
+    double next =
+        (diff - tail_[j]) / (point.first - points_[size - 1 - j].first);
+    tail_[j] = diff;
+    diff = next;
+  }
+  points_.push_back(point);
+  tail_.push_back(diff);
+  coeff_.push_back(diff);
+  primitive_.clear();
+}
+
+double NewtonInterpolation::getDerivative(double t, int order) {
+  double out;
+  evaluateDerivative(&t, &out, 1, order);
+  return out;
+}
+
+// With p = c(k) + (t - x(k)) q: p' = q + (t - x(k)) q' and
+// p'' = 2 q' + (t - x(k)) q'', innermost coefficient first
+void NewtonInterpolation::evaluateDerivative(const double* t, double* out,
+                                             size_t count, int order) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Newton polynomial not inited");
+  }
+  if (order != 1 && order != 2) {
+    throw std::invalid_argument("Error: derivative order must be 1 or 2");
+  }
+  const size_t degree = coeff_.size() - 1;
+  double x[kEvalBlock], value[kEvalBlock], first_d[kEvalBlock],
+      second_d[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    std::fill(x + block, x + kEvalBlock, 0.0);
+    std::copy(t + first, t + first + block, x);
+    std::fill(value, value + kEvalBlock, coeff_[degree]);
+    std::fill(first_d, first_d + kEvalBlock, 0.0);
+    std::fill(second_d, second_d + kEvalBlock, 0.0);
+    for (size_t k = degree; k-- > 0;) {
+      const double node = points_[k].first, c = coeff_[k];
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        const double dx = x[j] - node;
+        second_d[j] = second_d[j] * dx + 2.0 * first_d[j];
+        first_d[j] = first_d[j] * dx + value[j];
+        value[j] = value[j] * dx + c;
       }
-      coeff_.push_back(
-          (points_[i].second - calculateValue(i - 1, points_[i].first)) / p);
     }
+    std::copy(order == 1 ? first_d : second_d,
+              (order == 1 ? first_d : second_d) + block, out + first);
+  }
+}
+
+double NewtonInterpolation::getIntegral(double from, double to) {
+  double out;
+  integrate(&from, &to, &out, 1);
+  return out;
+}
+
+void NewtonInterpolation::integrate(const double* from, const double* to,
+                                    double* out, size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Newton polynomial not inited");
+  }
+  if (primitive_.empty()) {
+    calculatePrimitive();
+  }
+  for (size_t j = 0; j < count; ++j) {
+    out[j] = primitive(to[j]) - primitive(from[j]);
+  }
+}
+
+// The nested form expanded in u = (t - center) * scale, one factor
+// t - x(k) = u / scale + center - x(k) at a time, then integrated
+void NewtonInterpolation::calculatePrimitive() {
+  auto range = std::minmax_element(
+      points_.begin(), points_.end(),
+      [](const Point& a, const Point& b) { return a.first < b.first; });
+  center_ = (range.first->first + range.second->first) / 2;
+  const double half = (range.second->first - range.first->first) / 2;
+  scale_ = half > 0 ? 1.0 / half : 1.0;
+
+  const size_t size = coeff_.size();
+  std::vector<double> p(size, 0);
+  p[0] = coeff_[size - 1];
+  for (size_t k = size - 1; k-- > 0;) {
+    const double shift = center_ - points_[k].first;
+    for (size_t j = size - 1 - k; j > 0; --j) {
+      p[j] = p[j] * shift + p[j - 1] / scale_;
+    }
+    p[0] = p[0] * shift + coeff_[k];
+  }
+  primitive_.assign(size + 1, 0);
+  for (size_t j = 0; j < size; ++j) {
+    primitive_[j + 1] = p[j] / (j + 1) / scale_;
+  }
+}
+
+double NewtonInterpolation::primitive(double t) const {
+  const double u = (t - center_) * scale_;
+  double result = 0;
+  for (size_t j = primitive_.size(); j-- > 0;) {
+    result = result * u + primitive_[j];
   }
+  return result;
 }
 
 double NewtonInterpolation::calculateValue(size_t degree, double t) {
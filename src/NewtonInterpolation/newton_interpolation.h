@@ -19,17 +19,36 @@ class NewtonInterpolation {
   void operator=(NewtonInterpolation&&) = delete;
 
   auto initNewtonPolynomial(const std::vector<Point>&) -> void;
-  auto initNewtonPolynomial(std::vector<DataPoint>&) -> void;
+  auto initNewtonPolynomial(const TimeSeries&) -> void;
+  auto addNode(const Point& point) -> void;
 
   auto getCoeff() -> std::vector<double>&;
   auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+  // Derivatives of order 1 or 2 carried along the nested form
+  auto getDerivative(double t, int order = 1) -> double;
+  auto evaluateDerivative(const double* t, double* out, size_t count,
+                          int order = 1) -> void;
+  // Definite integrals through the power form of the primitive over the
+  // nodes' range scaled to [-1, 1], built on the first query
+  auto getIntegral(double from, double to) -> double;
+  auto integrate(const double* from, const double* to, double* out,
+                 size_t count) -> void;
 
  private:
   auto calculateCoeff() -> void;
   auto calculateValue(size_t degree, double t) -> double;
+  auto calculatePrimitive() -> void;
+  auto primitive(double t) const -> double;
 
   std::vector<double> coeff_{};
+  std::vector<double> tail_{};
   std::vector<Point> points_{};
+  // Primitive as a polynomial in (t - center_) * scale_
+  std::vector<double> primitive_{};
+  double center_{0};
+  double scale_{1.0};
 };
 
 }  //   namespace s21
@@ -0,0 +1,144 @@
+#include "piecewise_newton.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+void PiecewiseNewton::init(const std::vector<Point>& points, size_t degree,
+                           size_t threads) {
+  points_ = points;
+  degree_ = degree;
+  build(threads);
+}
+
+void PiecewiseNewton::init(const TimeSeries& data_points, size_t degree,
+                           size_t threads) {
+  points_.clear();
+  points_.reserve(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    points_.push_back(
+        {static_cast<double>(data_points.time[i]), data_points.value[i]});
+  }
+  degree_ = degree;
+  build(threads);
+}
+
+std::vector<double> PiecewiseNewton::getCoeff(size_t segment) const {
+  auto first = coeff_.begin() + segment * (degree_ + 1);
+  return std::vector<double>(first, first + degree_ + 1);
+}
+
+size_t PiecewiseNewton::findSegment(double t) {
+  if (first_.empty()) {
+    throw std::domain_error("Error: Newton polynomial not inited");
+  }
+  size_t i = lookup_.find(t);
+  if (i == SegmentLookup::kNotFound) {
+    return t < lookup_.getKnots().front() ? 0 : first_.size() - 1;
+  }
+  return i - 1;
+}
+
+size_t PiecewiseNewton::findSegment(double t, size_t& cursor) const {
+  size_t i = lookup_.find(t, cursor);
+  if (i == SegmentLookup::kNotFound) {
+    return t < lookup_.getKnots().front() ? 0 : first_.size() - 1;
+  }
+  return i - 1;
+}
+
+double PiecewiseNewton::getValue(double t) {
+  const size_t stride = degree_ + 1;
+  const size_t row = findSegment(t) * stride;
+  double value = coeff_[row + degree_];
+  for (size_t k = degree_; k-- > 0;) {
+    value = value * (t - nodes_[row + k]) + coeff_[row + k];
+  }
+  return value;
+}
+
+// Same nested form as NewtonInterpolation::evaluate, with every lane reading
+// the nodes and coefficients of its own segment
+void PiecewiseNewton::evaluate(const double* t, double* out, size_t count) {
+  if (first_.empty()) {
+    throw std::domain_error("Error: Newton polynomial not inited");
+  }
+  const size_t stride = degree_ + 1;
+  size_t row[kEvalBlock];
+  double x[kEvalBlock], value[kEvalBlock];
+  size_t cursor = 1;
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      row[j] = 0;
+      x[j] = 0;
+    }
+    for (size_t j = 0; j < block; ++j) {
+      x[j] = t[first + j];
+      row[j] = findSegment(x[j], cursor) * stride;
+    }
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      value[j] = coeff_[row[j] + degree_];
+    }
+    for (size_t k = degree_; k-- > 0;) {
+      for (size_t j = 0; j < kEvalBlock; ++j) {
+        value[j] = value[j] * (x[j] - nodes_[row[j] + k]) + coeff_[row[j] + k];
+      }
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
+void PiecewiseNewton::build(size_t threads) {
+  first_.clear();
+  nodes_.clear();
+  coeff_.clear();
+  lookup_.clear();
+  if (degree_ == 0 || points_.size() <= degree_) {
+    throw std::invalid_argument("Error: not enough points for the degree");
+  }
+  const size_t size = points_.size();
+  for (size_t i = 0; i < size - 1; i += degree_) {
+    first_.push_back(i + degree_ < size ? i : size - degree_ - 1);
+  }
+  const size_t segments = first_.size();
+  nodes_.resize(segments * (degree_ + 1));
+  coeff_.resize(segments * (degree_ + 1));
+
+  ThreadPool& pool = ThreadPool::GetInstance();
+  if (threads == 0) {
+    threads = pool.size();
+  }
+  pool.parallelFor(0, segments, (segments + threads - 1) / threads,
+                   [this](size_t begin, size_t end) {
+                     buildSegments(begin, end);
+                   });
+
+  std::vector<double> knots{points_[first_[0]].first};
+  for (size_t first : first_) {
+    knots.push_back(points_[first + degree_].first);
+  }
+  lookup_.init(std::move(knots));
+}
+
+// Divided differences of every segment in place, as in
+// NewtonInterpolation::calculateCoeff
+void PiecewiseNewton::buildSegments(size_t begin, size_t end) {
+  const size_t stride = degree_ + 1;
+  for (size_t segment = begin; segment < end; ++segment) {
+    const Point* point = points_.data() + first_[segment];
+    double* x = nodes_.data() + segment * stride;
+    double* c = coeff_.data() + segment * stride;
+    for (size_t i = 0; i < stride; ++i) {
+      x[i] = point[i].first;
+      c[i] = point[i].second;
+    }
+    for (size_t j = 1; j < stride; ++j) {
+      for (size_t i = degree_; i >= j; --i) {
+        c[i] = (c[i] - c[i - 1]) / (x[i] - x[i - j]);
+      }
+    }
+  }
+}
+
+}  //   namespace s21
@@ -0,0 +1,64 @@
+#ifndef SRC_NEWTONINTERPOLATION_PIECEWISE_NEWTON_H_
+#define SRC_NEWTONINTERPOLATION_PIECEWISE_NEWTON_H_
+
+//
+// Newton polynomials of one degree over consecutive segments of a dataset.
+// Segment k interpolates the degree + 1 points starting at k * degree, the
+// last one the final degree + 1 points, as plotted by the GUI. Nodes and
+// coefficients of all segments are kept in two flat arrays of
+// (degree + 1) values per segment; a query finds its segment through a
+// SegmentLookup over the segment ends and costs O(degree).
+//
+
+#include <stdexcept>
+#include <vector>
+
+#include "../SplineInterpolation/segment_lookup.h"
+#include "../ThreadPool/thread_pool.h"
+#include "../types.h"
+
+namespace s21 {
+
+class PiecewiseNewton {
+ public:
+  PiecewiseNewton() {}
+  ~PiecewiseNewton() = default;
+  PiecewiseNewton(const PiecewiseNewton&) = delete;
+  PiecewiseNewton(PiecewiseNewton&&) = delete;
+  void operator=(const PiecewiseNewton&) = delete;
+  void operator=(PiecewiseNewton&&) = delete;
+
+  // threads: tasks the segments are split into on the shared ThreadPool,
+  // 0 for one per pool thread
+  auto init(const std::vector<Point>& points, size_t degree,
+            size_t threads = 1) -> void;
+  auto init(const TimeSeries& data_points, size_t degree, size_t threads = 1)
+      -> void;
+
+  auto getDegree() const -> size_t { return degree_; }
+  auto getSegmentCount() const -> size_t { return first_.size(); }
+  auto getFirstPoint(size_t segment) const -> size_t {
+    return first_[segment];
+  }
+  auto getCoeff(size_t segment) const -> std::vector<double>;
+  auto findSegment(double t) -> size_t;
+
+  auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+ private:
+  auto build(size_t threads) -> void;
+  auto buildSegments(size_t begin, size_t end) -> void;
+  auto findSegment(double t, size_t& cursor) const -> size_t;
+
+  size_t degree_{0};
+  std::vector<size_t> first_{};
+  std::vector<double> nodes_{};
+  std::vector<double> coeff_{};
+  std::vector<Point> points_{};
+  SegmentLookup lookup_{};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_NEWTONINTERPOLATION_PIECEWISE_NEWTON_H_
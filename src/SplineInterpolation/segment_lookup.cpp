@@ -0,0 +1,143 @@
+#include "segment_lookup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace s21 {
+
+namespace {
+
+// Knots closer than this fraction of the step to the uniform grid keep the
+// arithmetic guess at most one interval off
+constexpr double kUniformTolerance = 0.25;
+
+}  //   namespace
+
+void SegmentLookup::init(std::vector<double>&& knots) {
+  knots_ = std::move(knots);
+  cursor_ = 1;
+  checkUniform();
+}
+
+void SegmentLookup::push_back(double knot) {
+  knots_.push_back(knot);
+  if (knots_.size() == 2) {
+    checkUniform();
+  } else if (uniform_) {
+    double expected = knots_.front() + (knots_.size() - 1) * step_;
+    uniform_ = std::fabs(knot - expected) <= kUniformTolerance * step_;
+  }
+}
+
+void SegmentLookup::clear() {
+  knots_.clear();
+  cursor_ = 1;
+  uniform_ = false;
+}
+
+size_t SegmentLookup::find(double t, size_t& cursor) const {
+  const size_t size = knots_.size();
+  if (size < 2 || std::isnan(t)) {
+    return kNotFound;
+  }
+  size_t i = upperBound(t - s21::kEps, cursor);
+  if (i == 0) {
+    if (!(knots_[0] - s21::kEps < t)) {
+      return kNotFound;
+    }
+    i = 1;
+  }
+  return i < size ? i : kNotFound;
+}
+
+void SegmentLookup::checkUniform() {
+  uniform_ = false;
+  if (knots_.size() < 2) {
+    return;
+  }
+  step_ = (knots_.back() - knots_.front()) / (knots_.size() - 1);
+  if (!(step_ > 0)) {
+    return;
+  }
+  for (size_t i = 1; i < knots_.size(); ++i) {
+    double expected = knots_.front() + i * step_;
+    if (std::fabs(knots_[i] - expected) > kUniformTolerance * step_) {
+      return;
+    }
+  }
+  inv_step_ = 1.0 / step_;
+  uniform_ = true;
+}
+
+// First index i with knots_[i] > x (knots_.size() if there is none)
+size_t SegmentLookup::upperBound(double x, size_t& cursor) const {
+  const size_t size = knots_.size();
+  size_t i = 0;
+  if (uniform_) {
+    double guess = (x - knots_.front()) * inv_step_;
+    if (!(guess > 0)) {
+      i = 0;
+    } else {
+      i = guess >= size ? size : static_cast<size_t>(guess) + 1;
+    }
+    while (i < size && knots_[i] <= x) ++i;
+    while (i > 0 && knots_[i - 1] > x) --i;
+  } else {
+    size_t lo = std::min(cursor, size), hi = lo;
+    if (lo > 0 && knots_[lo - 1] > x) {
+      lo = 0;
+      --hi;
+    } else {
+      for (size_t step = 1; hi < size && knots_[hi] <= x; step <<= 1) {
+        lo = hi + 1;
+        hi = std::min(hi + step, size);
+      }
+    }
+    i = std::upper_bound(knots_.begin() + lo, knots_.begin() + hi, x) -
+        knots_.begin();
+  }
+  cursor = i;
+  return i;
+}
+
+double evaluateSegments(const SplineSegment* coeff, SegmentLookup& lookup,
+                        double t) {
+  size_t i = lookup.find(t);
+  if (i == SegmentLookup::kNotFound) {
+    throw std::invalid_argument("Argument is out of range");
+  }
+  const SplineSegment& s = coeff[i];
+  t -= lookup.getKnots()[i];
+  return s.a + t * (s.b + t * (s.c + t * s.d));
+}
+
+// Lookups first, then the polynomials over a whole block; padding lanes
+// evaluate row 0 at its knot
+void evaluateSegments(const SplineSegment* coeff, SegmentLookup& lookup,
+                      const double* t, double* out, size_t count) {
+  const std::vector<double>& knots = lookup.getKnots();
+  size_t index[kEvalBlock];
+  double dt[kEvalBlock], value[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      index[j] = 0;
+      dt[j] = 0;
+    }
+    for (size_t j = 0; j < block; ++j) {
+      index[j] = lookup.find(t[first + j]);
+      if (index[j] == SegmentLookup::kNotFound) {
+        throw std::invalid_argument("Argument is out of range");
+      }
+      dt[j] = t[first + j] - knots[index[j]];
+    }
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      const SplineSegment& s = coeff[index[j]];
+      value[j] = s.a + dt[j] * (s.b + dt[j] * (s.c + dt[j] * s.d));
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
+}  //   namespace s21
@@ -0,0 +1,59 @@
+#ifndef SRC_SPLINEINTERPOLATION_SEGMENT_LOOKUP_H_
+#define SRC_SPLINEINTERPOLATION_SEGMENT_LOOKUP_H_
+
+//
+// Finds the knot interval [x(i-1), x(i)] holding t, with the same kEps
+// tolerance at the knots as the former linear scan: the first i >= 1 with
+// x(i) + kEps > t, provided x(0) - kEps < t.
+//  - uniformly spaced knots: index is computed arithmetically, O(1)
+//  - otherwise: galloping search from a cursor, amortized O(1) for
+//    monotone sweeps and O(log n) for random access
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "../types.h"
+#include "spline_coeff.h"
+
+namespace s21 {
+
+class SegmentLookup {
+ public:
+  static constexpr size_t kNotFound = 0;
+
+  SegmentLookup() {}
+  ~SegmentLookup() = default;
+
+  auto init(std::vector<double>&& knots) -> void;
+  auto push_back(double knot) -> void;
+  auto clear() -> void;
+
+  auto find(double t) -> size_t { return find(t, cursor_); }
+  auto find(double t, size_t& cursor) const -> size_t;
+
+  auto size() const -> size_t { return knots_.size(); }
+  auto isUniform() const -> bool { return uniform_; }
+  auto getKnots() const -> const std::vector<double>& { return knots_; }
+
+ private:
+  auto checkUniform() -> void;
+  auto upperBound(double x, size_t& cursor) const -> size_t;
+
+  std::vector<double> knots_{};
+  size_t cursor_{1};
+  bool uniform_{false};
+  double step_{0};
+  double inv_step_{0};
+};
+
+// Piecewise cubic in segment records, row i ending at knot i of lookup;
+// t out of the knots' range throws std::invalid_argument
+auto evaluateSegments(const SplineSegment* coeff, SegmentLookup& lookup,
+                      double t) -> double;
+auto evaluateSegments(const SplineSegment* coeff, SegmentLookup& lookup,
+                      const double* t, double* out, size_t count) -> void;
+
+}  //   namespace s21
+
+#endif  //  SRC_SPLINEINTERPOLATION_SEGMENT_LOOKUP_H_
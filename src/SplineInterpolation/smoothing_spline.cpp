@@ -0,0 +1,279 @@
+#include "smoothing_spline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace s21 {
+
+namespace {
+
+// GCV search: a grid of kGridSteps decades around the reference lambda,
+// kGridPoints per decade, then golden section around the best grid point
+constexpr int kGridSteps = 6;
+constexpr int kGridPoints = 2;
+constexpr int kGoldenSteps = 24;
+
+}  //   namespace
+
+void SmoothingSpline::Band::resize(size_t size) {
+  d0.assign(size, 0);
+  d1.assign(size, 0);
+  d2.assign(size, 0);
+}
+
+void SmoothingSpline::initSmoothingSpline(const std::vector<Point>& points) {
+  x_.resize(points.size());
+  y_.resize(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    x_[i] = points[i].first;
+    y_[i] = points[i].second;
+  }
+  calculateCoeff();
+}
+
+void SmoothingSpline::initSmoothingSpline(const TimeSeries& data_points) {
+  x_.resize(data_points.size());
+  y_.resize(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    x_[i] = static_cast<double>(data_points.time[i]);
+    y_[i] = data_points.value[i];
+  }
+  calculateCoeff();
+}
+
+void SmoothingSpline::setSmoothing(double lambda) {
+  if (!(lambda >= 0)) {
+    throw std::invalid_argument("Error: smoothing must not be negative");
+  }
+  fixed_lambda_ = lambda;
+}
+
+SplineCoeffView SmoothingSpline::getCoeff() const {
+  return segmentView(coeff_);
+}
+
+double SmoothingSpline::getValue(double t) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Smoothing spline not inited");
+  }
+  return evaluateSegments(coeff_.data(), lookup_, t);
+}
+
+void SmoothingSpline::evaluate(const double* t, double* out,
+                               size_t count) {
+  if (coeff_.empty()) {
+    throw std::domain_error("Error: Smoothing spline not inited");
+  }
+  evaluateSegments(coeff_.data(), lookup_, t, out, count);
+}
+
+void SmoothingSpline::calculateCoeff() {
+  const size_t size = x_.size();
+  for (size_t i = 1; i < size; ++i) {
+    if (!(x_[i] > x_[i - 1])) {
+      coeff_.clear();
+      throw std::invalid_argument("Error: knots must be strictly increasing");
+    }
+  }
+  lookup_.init(std::vector<double>(x_));
+  coeff_.assign(size, SplineSegment{0, 0, 0, 0});
+  lambda_ = fixed_lambda_;
+  score_ = 0;
+  dof_ = 0;
+  gamma_.clear();
+  fitted_ = y_;
+  if (size > 2) {
+    prepare();
+    if (auto_) {
+      lambda_ = chooseSmoothing();
+    }
+    score_ = gcv(lambda_);
+  }
+  if (size > 0) {
+    updateSegments();
+  }
+}
+
+void SmoothingSpline::prepare() {
+  const size_t size = x_.size(), inner = size - 2;
+  const double scale = (x_.back() - x_.front()) / (size - 1);
+  h_.resize(size - 1);
+  for (size_t i = 0; i + 1 < size; ++i) {
+    h_[i] = (x_[i + 1] - x_[i]) / scale;
+  }
+  r_.resize(inner);
+  p_.resize(inner);
+  qty_.resize(inner);
+  // Column j of Q holds 1 / h(j), -1 / h(j) - 1 / h(j + 1), 1 / h(j + 1)
+  // in rows j..j + 2
+  for (size_t j = 0; j < inner; ++j) {
+    const double q0 = 1.0 / h_[j], q2 = 1.0 / h_[j + 1], q1 = -q0 - q2;
+    r_.d0[j] = (h_[j] + h_[j + 1]) / 3.0;
+    p_.d0[j] = q0 * q0 + q1 * q1 + q2 * q2;
+    qty_[j] = (y_[j + 2] - y_[j + 1]) * q2 - (y_[j + 1] - y_[j]) * q0;
+    if (j + 1 < inner) {
+      const double next0 = 1.0 / h_[j + 1];
+      const double next1 = -next0 - 1.0 / h_[j + 2];
+      r_.d1[j] = h_[j + 1] / 6.0;
+      p_.d1[j] = q1 * next0 + q2 * next1;
+    }
+    if (j + 2 < inner) {
+      p_.d2[j] = q2 / h_[j + 2];
+    }
+  }
+  ldl_.resize(inner);
+  inverse_.resize(inner);
+  gamma_.resize(inner);
+}
+
+// Rows of B = R + lambda * Q'Q: B(j, j) = L(j, j - 1)^2 D(j - 1) +
+// L(j, j - 2)^2 D(j - 2) + D(j), and likewise below the diagonal
+void SmoothingSpline::factorize(double lambda) {
+  const size_t inner = r_.d0.size();
+  std::vector<double>& d = ldl_.d0;
+  std::vector<double>& l1 = ldl_.d1;
+  std::vector<double>& l2 = ldl_.d2;
+  for (size_t j = 0; j < inner; ++j) {
+    double diag = r_.d0[j] + lambda * p_.d0[j];
+    if (j >= 2) {
+      l2[j] = lambda * p_.d2[j - 2] / d[j - 2];
+      diag -= l2[j] * l2[j] * d[j - 2];
+    }
+    if (j >= 1) {
+      double lower = r_.d1[j - 1] + lambda * p_.d1[j - 1];
+      if (j >= 2) {
+        lower -= l2[j] * d[j - 2] * l1[j - 1];
+      }
+      l1[j] = lower / d[j - 1];
+      diag -= l1[j] * l1[j] * d[j - 1];
+    }
+    d[j] = diag;
+  }
+}
+
+void SmoothingSpline::solve(double lambda) {
+  factorize(lambda);
+  const size_t inner = gamma_.size();
+  for (size_t j = 0; j < inner; ++j) {
+    double z = qty_[j];
+    if (j >= 1) z -= ldl_.d1[j] * gamma_[j - 1];
+    if (j >= 2) z -= ldl_.d2[j] * gamma_[j - 2];
+    gamma_[j] = z;
+  }
+  for (size_t j = inner; j-- > 0;) {
+    double z = gamma_[j] / ldl_.d0[j];
+    if (j + 1 < inner) z -= ldl_.d1[j + 1] * gamma_[j + 1];
+    if (j + 2 < inner) z -= ldl_.d2[j + 2] * gamma_[j + 2];
+    gamma_[j] = z;
+  }
+  fitted_ = y_;
+  for (size_t j = 0; j < inner; ++j) {
+    const double q0 = 1.0 / h_[j], q2 = 1.0 / h_[j + 1];
+    fitted_[j] -= lambda * q0 * gamma_[j];
+    fitted_[j + 1] += lambda * (q0 + q2) * gamma_[j];
+    fitted_[j + 2] -= lambda * q2 * gamma_[j];
+  }
+}
+
+// n - tr(A) = lambda * tr(B^-1 Q'Q); Q'Q has two bands on either side,
+// so only that band of B^-1 is needed. From B^-1 = D^-1 L^-1 +
+// (I - L') B^-1 it follows upwards from the last row
+double SmoothingSpline::gcv(double lambda) {
+  solve(lambda);
+  const size_t inner = gamma_.size(), size = x_.size();
+  std::vector<double>& s0 = inverse_.d0;
+  std::vector<double>& s1 = inverse_.d1;
+  std::vector<double>& s2 = inverse_.d2;
+  double trace = 0;
+  for (size_t j = inner; j-- > 0;) {
+    const double l1 = j + 1 < inner ? ldl_.d1[j + 1] : 0.0;
+    const double l2 = j + 2 < inner ? ldl_.d2[j + 2] : 0.0;
+    const double next0 = j + 1 < inner ? s0[j + 1] : 0.0;
+    const double next1 = j + 1 < inner ? s1[j + 1] : 0.0;
+    const double after0 = j + 2 < inner ? s0[j + 2] : 0.0;
+    s1[j] = -l1 * next0 - l2 * next1;
+    s2[j] = -l1 * next1 - l2 * after0;
+    s0[j] = 1.0 / ldl_.d0[j] - l1 * s1[j] - l2 * s2[j];
+    trace += s0[j] * p_.d0[j] + 2.0 * (s1[j] * p_.d1[j] + s2[j] * p_.d2[j]);
+  }
+  dof_ = lambda * trace;
+  if (!(dof_ > 0)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double rss = 0;
+  for (size_t i = 0; i < size; ++i) {
+    rss += (y_[i] - fitted_[i]) * (y_[i] - fitted_[i]);
+  }
+  return size * rss / (dof_ * dof_);
+}
+
+// Searched in log10(lambda) around the lambda balancing tr(R) and
+// tr(Q'Q), the scale where both terms of the system weigh the same
+double SmoothingSpline::chooseSmoothing() {
+  double trace_r = 0, trace_p = 0;
+  for (size_t j = 0; j < r_.d0.size(); ++j) {
+    trace_r += r_.d0[j];
+    trace_p += p_.d0[j];
+  }
+  const double center = std::log10(trace_r / trace_p);
+  auto score = [this](double power) { return gcv(std::pow(10.0, power)); };
+
+  const double step = 1.0 / kGridPoints;
+  double best = center, best_score = score(center);
+  for (int k = -kGridSteps * kGridPoints; k <= kGridSteps * kGridPoints; ++k) {
+    const double power = center + k * step;
+    const double value = score(power);
+    if (value < best_score) {
+      best = power;
+      best_score = value;
+    }
+  }
+  const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+  double lo = best - step, hi = best + step;
+  double left = hi - ratio * (hi - lo), right = lo + ratio * (hi - lo);
+  double f_left = score(left), f_right = score(right);
+  for (int k = 0; k < kGoldenSteps; ++k) {
+    if (f_left < f_right) {
+      hi = right;
+      right = left;
+      f_right = f_left;
+      left = hi - ratio * (hi - lo);
+      f_left = score(left);
+    } else {
+      lo = left;
+      left = right;
+      f_left = f_right;
+      right = lo + ratio * (hi - lo);
+      f_right = score(right);
+    }
+  }
+  const double power = f_left < f_right ? left : right;
+  return std::min(f_left, f_right) < best_score ? std::pow(10.0, power)
+                                                : std::pow(10.0, best);
+}
+
+// Row i holds the segment ending at knot i, from the fitted values and
+// the second derivatives, 0 at both ends
+void SmoothingSpline::updateSegments() {
+  const size_t size = x_.size();
+  const double scale =
+      size > 1 ? (x_.back() - x_.front()) / (size - 1) : 1.0;
+  auto moment = [this, size, scale](size_t i) {
+    return i == 0 || i + 1 >= size || gamma_.empty()
+               ? 0.0
+               : gamma_[i - 1] / (scale * scale);
+  };
+  coeff_[0].a = fitted_[0];
+  for (size_t i = 1; i < size; ++i) {
+    const double h = x_[i] - x_[i - 1];
+    const double m0 = moment(i - 1), m1 = moment(i);
+    coeff_[i].a = fitted_[i];
+    coeff_[i].b =
+        (fitted_[i] - fitted_[i - 1]) / h + h * (2.0 * m1 + m0) / 6.0;
+    coeff_[i].c = m1 / 2.0;
+    coeff_[i].d = (m1 - m0) / (6.0 * h);
+  }
+}
+
+}  //   namespace s21
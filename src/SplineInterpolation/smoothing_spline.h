@@ -0,0 +1,93 @@
+#ifndef SRC_SPLINEINTERPOLATION_SMOOTHING_SPLINE_H_
+#define SRC_SPLINEINTERPOLATION_SMOOTHING_SPLINE_H_
+
+//
+// Cubic smoothing spline (Reinsch): the natural cubic spline g minimizing
+//   sum((y(i) - g(x(i)))^2) + lambda * integral(g''(x)^2 dx)
+// lambda = 0 interpolates, lambda -> infinity tends to the least squares
+// line. The abscissas are measured in mean knot spacings for the penalty,
+// so lambda does not depend on the time unit. The second derivatives at
+// the inner knots solve the pentadiagonal system
+//   (R + lambda * Q'Q) gamma = Q'y,   g = y - lambda * Q * gamma
+// by a banded LDL' factorization, O(n) time and memory. The automatic
+// mode minimizes generalized cross-validation
+//   GCV(lambda) = n * RSS / (n - tr(A))^2
+// taking tr(A) from the band of (R + lambda * Q'Q)^-1 (Hutchinson - de
+// Hoog), again O(n) per lambda. Coefficients are stored like the cubic
+// spline ones (see spline_coeff.h, segments layout).
+//
+
+#include <stdexcept>
+#include <vector>
+
+#include "../types.h"
+#include "segment_lookup.h"
+#include "spline_coeff.h"
+
+namespace s21 {
+
+class SmoothingSpline {
+ public:
+  SmoothingSpline() {}
+  ~SmoothingSpline() = default;
+  SmoothingSpline(const SmoothingSpline&) = delete;
+  SmoothingSpline(SmoothingSpline&&) = delete;
+  void operator=(const SmoothingSpline&) = delete;
+  void operator=(SmoothingSpline&&) = delete;
+
+  // Knots must be strictly increasing
+  auto initSmoothingSpline(const std::vector<Point>&) -> void;
+  auto initSmoothingSpline(const TimeSeries&) -> void;
+
+  // Take effect at the next init
+  auto setSmoothing(double lambda) -> void;
+  auto setAutoSmoothing(bool on) -> void { auto_ = on; }
+  // lambda of the last fit, the chosen one in the automatic mode
+  auto getSmoothing() const -> double { return lambda_; }
+  // GCV score of the last fit
+  auto getScore() const -> double { return score_; }
+  // n - tr(A) of the last fit, the residual degrees of freedom
+  auto getResidualDof() const -> double { return dof_; }
+
+  auto getCoeff() const -> SplineCoeffView;
+  auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+ private:
+  struct Band {
+    std::vector<double> d0, d1, d2;
+    auto resize(size_t size) -> void;
+  };
+
+  auto calculateCoeff() -> void;
+  auto prepare() -> void;
+  auto factorize(double lambda) -> void;
+  auto solve(double lambda) -> void;
+  auto gcv(double lambda) -> double;
+  auto chooseSmoothing() -> double;
+  auto updateSegments() -> void;
+
+  std::vector<double> x_{};
+  std::vector<double> y_{};
+  std::vector<SplineSegment> coeff_{};
+  SegmentLookup lookup_{};
+  double lambda_{1};
+  double fixed_lambda_{1};
+  double score_{0};
+  double dof_{0};
+  bool auto_{false};
+
+  // Scaled spacings, bands of R and Q'Q, Q'y
+  std::vector<double> h_{};
+  Band r_{}, p_{};
+  std::vector<double> qty_{};
+  // LDL' of R + lambda * Q'Q: D and the two subdiagonals of L
+  Band ldl_{};
+  Band inverse_{};
+  std::vector<double> gamma_{};
+  std::vector<double> fitted_{};
+};
+
+}  //   namespace s21
+
+#endif  //  SRC_SPLINEINTERPOLATION_SMOOTHING_SPLINE_H_
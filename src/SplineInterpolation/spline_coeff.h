@@ -0,0 +1,68 @@
+#ifndef SRC_SPLINEINTERPOLATION_SPLINE_COEFF_H_
+#define SRC_SPLINEINTERPOLATION_SPLINE_COEFF_H_
+
+//
+// Flat cubic spline coefficient storage.
+// Row i holds the segment ending at knot i:
+//   S(t) = a + b * (t - x(i)) + c * (t - x(i))^2 + d * (t - x(i))^3
+// Both layouts live in one block of 32-byte aligned SplineSegment records:
+//  - kSegments:   a, b, c, d of one segment side by side (one cache line
+//                 fetch per evaluation)
+//  - kComponents: four arrays a[], b[], c[], d[], each padded to a multiple
+//                 of four rows so every array starts 32-byte aligned
+//
+
+#include <cstddef>
+#include <vector>
+
+namespace s21 {
+
+constexpr size_t kSplineCoeffCount = 4;
+
+struct alignas(32) SplineSegment {
+  double a, b, c, d;
+};
+static_assert(sizeof(SplineSegment) == kSplineCoeffCount * sizeof(double),
+              "SplineSegment records must be packed back to back");
+
+enum class CoeffLayout { kSegments, kComponents };
+
+// Non-owning view, valid until the next init of the spline it came from
+class SplineCoeffView {
+ public:
+  SplineCoeffView() {}
+  SplineCoeffView(const double* data, size_t rows, size_t row_stride,
+                  size_t col_stride)
+      : data_(data),
+        rows_(rows),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {}
+
+  auto rows() const -> size_t { return rows_; }
+  auto cols() const -> size_t { return kSplineCoeffCount; }
+  auto empty() const -> bool { return rows_ == 0; }
+  auto data() const -> const double* { return data_; }
+  auto layout() const -> CoeffLayout {
+    return col_stride_ == 1 ? CoeffLayout::kSegments : CoeffLayout::kComponents;
+  }
+  auto operator()(size_t row, size_t col) const -> double {
+    return data_[row * row_stride_ + col * col_stride_];
+  }
+
+ private:
+  const double* data_{nullptr};
+  size_t rows_{0};
+  size_t row_stride_{kSplineCoeffCount};
+  size_t col_stride_{1};
+};
+
+// View of segment records stored back to back (kSegments layout)
+inline auto segmentView(const std::vector<SplineSegment>& coeff)
+    -> SplineCoeffView {
+  return SplineCoeffView(coeff.empty() ? nullptr : &coeff.front().a,
+                         coeff.size(), kSplineCoeffCount, 1);
+}
+
+}  //   namespace s21
+
+#endif  //  SRC_SPLINEINTERPOLATION_SPLINE_COEFF_H_
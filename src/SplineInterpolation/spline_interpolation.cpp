@@ -1,90 +1,461 @@
 #include "spline_interpolation.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace s21 {
 
+namespace {
+
+// Rows per partition of the parallel solve, at least
+constexpr size_t kMinPartition = 4096;
+
+}  //   namespace
+
+// One block for all rows, reused as long as the size does not grow
 void SplineInterpolation::resetCoeff(size_t number) {
-  for (auto& it : coeff_) {
-    it.clear();
+  rows_ = number;
+  size_t records = number;
+  if (layout_ == CoeffLayout::kSegments) {
+    row_stride_ = kSplineCoeffCount;
+    col_stride_ = 1;
+  } else {
+    records = (number + kSplineCoeffCount - 1) / kSplineCoeffCount *
+              kSplineCoeffCount;
+    row_stride_ = 1;
+    col_stride_ = records;
   }
-  coeff_.resize(number);
-  for (auto& it : coeff_) {
-    it.resize(4);
+  coeff_.resize(records);
+  std::fill(coeff_.begin(), coeff_.end(), SplineSegment{0, 0, 0, 0});
+  data_ = coeff_.empty() ? nullptr : &coeff_.front().a;
+}
+
+// Keeps the stored rows; the component layout grows its arrays
+// geometrically so appends stay amortized O(1)
+void SplineInterpolation::growCoeff(size_t number) {
+  if (layout_ == CoeffLayout::kSegments) {
+    coeff_.resize(number);
+  } else if (number > col_stride_) {
+    size_t stride = std::max(2 * col_stride_, (number + kSplineCoeffCount - 1) /
+                                                  kSplineCoeffCount *
+                                                  kSplineCoeffCount);
+    std::vector<SplineSegment> grown(stride, SplineSegment{0, 0, 0, 0});
+    double* target = &grown.front().a;
+    for (size_t k = 0; k < kSplineCoeffCount; ++k) {
+      std::copy(data_ + k * col_stride_, data_ + k * col_stride_ + rows_,
+                target + k * stride);
+    }
+    coeff_.swap(grown);
+    col_stride_ = stride;
   }
+  rows_ = number;
+  data_ = coeff_.empty() ? nullptr : &coeff_.front().a;
+}
+
+void SplineInterpolation::setLayout(CoeffLayout layout) {
+  if (layout == layout_) {
+    return;
+  }
+  std::vector<double> saved(rows_ * kSplineCoeffCount);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t k = 0; k < kSplineCoeffCount; ++k) {
+      saved[i * kSplineCoeffCount + k] = coeff(i, k);
+    }
+  }
+  layout_ = layout;
+  resetCoeff(rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t k = 0; k < kSplineCoeffCount; ++k) {
+      coeff(i, k) = saved[i * kSplineCoeffCount + k];
+    }
+  }
+}
+
+void SplineInterpolation::resetLookup() {
+  std::vector<double> knots(points_.size());
+  for (size_t i = 0; i < points_.size(); ++i) {
+    knots[i] = points_[i].first;
+  }
+  lookup_.init(std::move(knots));
 }
 
 void SplineInterpolation::initCubicSpline(const std::vector<Point>& points) {
   points_ = points;
   resetCoeff(points.size());
+  resetLookup();
   calculateCoeff();
 }
 
-void SplineInterpolation::initCubicSpline(std::vector<DataPoint>& data_points) {
+void SplineInterpolation::initCubicSpline(const TimeSeries& data_points) {
   points_.clear();
-  for (auto& it : data_points) {
-    points_.push_back({std::mktime(&it.first), it.second});
+  points_.reserve(data_points.size());
+  for (size_t i = 0; i < data_points.size(); ++i) {
+    points_.push_back(
+        {static_cast<double>(data_points.time[i]), data_points.value[i]});
   }
   resetCoeff(data_points.size());
+  resetLookup();
   calculateCoeff();
 }
 
-Matrix& SplineInterpolation::getCoeff() { return coeff_; }
+void SplineInterpolation::appendPoint(const Point& point) {
+  if (!points_.empty() && !(point.first > points_.back().first)) {
+    throw std::invalid_argument(
+        "Error: appended point must be later than the last knot");
+  }
+  points_.push_back(point);
+  lookup_.push_back(point.first);
+  growCoeff(points_.size());
+  if (points_.size() < 4) {
+    calculateCoeff();
+    return;
+  }
+
+  const size_t size = points_.size() - 1;
+  coeff(size, 0) = point.second;
+  alpha_.push_back(0);
+  beta_.push_back(0);
+  sweepForward(size - 1);
+  coeff(size, 2) = lastMoment();
+
+  size_t first = size;
+  for (size_t i = size - 1; i > 0; --i) {
+    double updated = (alpha_[i] * coeff(i + 1, 2) + beta_[i]) / 2.0;
+    double delta = std::fabs(updated - coeff(i, 2));
+    coeff(i, 2) = updated;
+    first = i;
+    if (delta <= append_tolerance_ * std::fabs(updated)) {
+      break;
+    }
+  }
+  updateSegments(first);
+  integral_.resize(std::min(integral_.size(), first));
+}
+
+void SplineInterpolation::appendPoints(const std::vector<Point>& points) {
+  for (auto& it : points) {
+    appendPoint(it);
+  }
+}
+
+void SplineInterpolation::setAppendTolerance(double tolerance) {
+  append_tolerance_ = tolerance;
+}
+
+SplineCoeffView SplineInterpolation::getCoeff() const {
+  return SplineCoeffView(data_, rows_, row_stride_, col_stride_);
+}
 
 double SplineInterpolation::getValue(double t) {
-  if (coeff_.empty()) {
+  if (rows_ == 0) {
     throw std::domain_error("Error: Spline polynomial not inited");
   }
   return calculateValue(t);
 }
 
+void SplineInterpolation::evaluate(const double* t, double* out,
+                                   size_t count) {
+  if (rows_ == 0) {
+    throw std::domain_error("Error: Spline polynomial not inited");
+  }
+  size_t index[kEvalBlock];
+  double dt[kEvalBlock], value[kEvalBlock];
+  for (size_t first = 0; first < count; first += kEvalBlock) {
+    const size_t block = std::min(kEvalBlock, count - first);
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      index[j] = 1;
+      dt[j] = 0;
+    }
+    for (size_t j = 0; j < block; ++j) {
+      index[j] = lookup_.find(t[first + j]);
+      if (index[j] == SegmentLookup::kNotFound) {
+        throw std::invalid_argument("Argument is out of range");
+      }
+      dt[j] = t[first + j] - points_[index[j]].first;
+    }
+    const double* a = data_;
+    const double* b = data_ + col_stride_;
+    const double* c = data_ + 2 * col_stride_;
+    const double* d = data_ + 3 * col_stride_;
+    for (size_t j = 0; j < kEvalBlock; ++j) {
+      const size_t row = index[j] * row_stride_;
+      value[j] = a[row] + dt[j] * (b[row] + dt[j] * (c[row] + dt[j] * d[row]));
+    }
+    std::copy(value, value + block, out + first);
+  }
+}
+
 void SplineInterpolation::calculateCoeff() {
-  if (!points_.empty()) {
+  integral_.clear();
+  if (points_.size() > 1) {
     size_t size = points_.size() - 1;
 
     for (size_t i = 0; i <= size; ++i) {
-      coeff_[i][0] = points_[i].second;
-    }
-    coeff_[0][2] = 0;
-
-    double a{0}, f{0}, c{0};
-    std::vector<double> alpha(size, 0);
-    std::vector<double> beta(size, 0);
-    for (size_t i = 1; i < size; ++i) {
-      double b{0}, z{0};
-      a = points_[i].first - points_[i - 1].first;
-      b = points_[i + 1].first - points_[i].first;
-      c = 2.0 * (points_[i + 1].first - points_[i - 1].first);
-      f = 6.0 * ((points_[i + 1].second - points_[i].second) / b -
-                 (points_[i].second - points_[i - 1].second) / a);
-      z = a * alpha[i - 1] + c;
-      alpha[i] = -b / z;
-      beta[i] = (f - a * beta[i - 1]) / z;
-    }
-
-    coeff_[size][2] =
-        (f - a * beta[size - 1]) / (c + a * alpha[size - 1]) / 2.0;
+      coeff(i, 0) = points_[i].second;
+    }
+    coeff(0, 2) = 0;
+
+    alpha_.assign(size, 0);
+    beta_.assign(size, 0);
+    if (pool_->size() > 1 && points_.size() >= parallel_threshold_) {
+      solveParallel();
+      return;
+    }
+    sweepForward(1);
+
+    coeff(size, 2) = lastMoment();
     for (size_t i = size - 1; i > 0; --i) {
-      coeff_[i][2] = (alpha[i] * coeff_[i + 1][2] + beta[i]) / 2.0;
+      coeff(i, 2) = (alpha_[i] * coeff(i + 1, 2) + beta_[i]) / 2.0;
+    }
+    updateSegments(1);
+  } else if (!points_.empty()) {
+    coeff(0, 0) = points_[0].second;
+  }
+}
+
+// Row i of the system: a * M(i - 1) + c * M(i) + b * M(i + 1) = f
+void SplineInterpolation::sweepRow(size_t i, double& a, double& b, double& c,
+                                   double& f) const {
+  a = points_[i].first - points_[i - 1].first;
+  b = points_[i + 1].first - points_[i].first;
+  c = 2.0 * (points_[i + 1].first - points_[i - 1].first);
+  f = 6.0 * ((points_[i + 1].second - points_[i].second) / b -
+             (points_[i].second - points_[i - 1].second) / a);
+}
+
+void SplineInterpolation::sweepForward(size_t first) {
+  for (size_t i = first; i + 1 < points_.size(); ++i) {
+    double a, b, c, f;
+    sweepRow(i, a, b, c, f);
+    double z = a * alpha_[i - 1] + c;
+    alpha_[i] = -b / z;
+    beta_[i] = (f - a * beta_[i - 1]) / z;
+  }
+}
+
+// Closing equation of the sweep, taken from the last inner knot
+double SplineInterpolation::lastMoment() {
+  const size_t size = points_.size() - 1;
+  double a{0}, f{0}, c{0};
+  if (size > 1) {
+    const size_t i = size - 1;
+    a = points_[i].first - points_[i - 1].first;
+    c = 2.0 * (points_[i + 1].first - points_[i - 1].first);
+    f = 6.0 * ((points_[i + 1].second - points_[i].second) /
+                   (points_[i + 1].first - points_[i].first) -
+               (points_[i].second - points_[i - 1].second) / a);
+  }
+  return (f - a * beta_[size - 1]) / (c + a * alpha_[size - 1]) / 2.0;
+}
+
+// The sweep as a partitioned scan. Every recurrence of it maps the value
+// entering a partition to the one leaving it by a transform that can be
+// built without knowing that value:
+//   alpha(i) = -b / (a * alpha(i - 1) + c), a linear fraction, composed
+//     as the 2 x 2 matrix product [0 -b; a c] (normalized against
+//     overflow);
+//   beta(i) = (f - a * beta(i - 1)) / z, affine once alpha is known;
+//   the back substitution C(i) = (alpha(i) * C(i + 1) + beta(i)) / 2,
+//     affine too, composed downwards.
+// Each recurrence takes one parallel pass building the transforms and a
+// serial pass over the partition boundaries; the partitions then run the
+// serial formulas from their exact entry values
+void SplineInterpolation::solveParallel() {
+  const size_t size = points_.size() - 1;
+  const size_t parts = std::max<size_t>(
+      1, std::min(4 * pool_->size(), (size - 1) / kMinPartition));
+  std::vector<size_t> bound(parts + 1);
+  for (size_t k = 0; k <= parts; ++k) {
+    bound[k] = 1 + (size - 1) * k / parts;
+  }
+  struct Transform {
+    double m[4]{1, 0, 0, 1};
+  };
+  std::vector<Transform> fraction(parts);
+  std::vector<double> scale(parts), shift(parts);
+  auto run = [this, parts](const ThreadPool::RangeJob& job) {
+    pool_->parallelFor(0, parts, 1, job);
+  };
+
+  run([this, &bound, &fraction](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      double* m = fraction[k].m;
+      for (size_t i = bound[k]; i < bound[k + 1]; ++i) {
+        double a, b, c, f;
+        sweepRow(i, a, b, c, f);
+        const double m0 = -b * m[2], m1 = -b * m[3];
+        const double m2 = a * m[0] + c * m[2], m3 = a * m[1] + c * m[3];
+        const double norm = std::max(std::max(std::fabs(m0), std::fabs(m1)),
+                                     std::max(std::fabs(m2), std::fabs(m3)));
+        m[0] = m0 / norm;
+        m[1] = m1 / norm;
+        m[2] = m2 / norm;
+        m[3] = m3 / norm;
+      }
     }
+  });
+  for (size_t k = 0; k + 1 < parts; ++k) {
+    const double* m = fraction[k].m;
+    const double x = alpha_[bound[k] - 1];
+    alpha_[bound[k + 1] - 1] = (m[0] * x + m[1]) / (m[2] * x + m[3]);
+  }
+
+  // The last entry of a partition other than the final one is already
+  // set by the boundary pass and read by the next partition, so the
+  // partitions carry it locally instead of storing it again
+  run([this, &bound, &scale, &shift, parts](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const size_t last = bound[k + 1] - (k + 1 < parts ? 1 : 0);
+      double prev = alpha_[bound[k] - 1], u = 1, v = 0;
+      for (size_t i = bound[k]; i < bound[k + 1]; ++i) {
+        double a, b, c, f;
+        sweepRow(i, a, b, c, f);
+        const double z = a * prev + c;
+        prev = -b / z;
+        if (i < last) alpha_[i] = prev;
+        u *= -a / z;
+        v = (f - a * v) / z;
+      }
+      scale[k] = u;
+      shift[k] = v;
+    }
+  });
+  for (size_t k = 0; k + 1 < parts; ++k) {
+    beta_[bound[k + 1] - 1] = scale[k] * beta_[bound[k] - 1] + shift[k];
+  }
 
-    for (size_t i = size; i > 0; --i) {
-      double h = points_[i].first - points_[i - 1].first;
-      coeff_[i][3] = (coeff_[i][2] - coeff_[i - 1][2]) / 3.0 / h;
-      coeff_[i][1] = (2.0 * coeff_[i][2] + coeff_[i - 1][2]) * h / 3.0 +
-                     (coeff_[i][0] - coeff_[i - 1][0]) / h;
+  run([this, &bound, &scale, &shift, parts](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const size_t last = bound[k + 1] - (k + 1 < parts ? 1 : 0);
+      double prev = beta_[bound[k] - 1];
+      for (size_t i = bound[k]; i < last; ++i) {
+        double a, b, c, f;
+        sweepRow(i, a, b, c, f);
+        const double z = a * alpha_[i - 1] + c;
+        prev = (f - a * prev) / z;
+        beta_[i] = prev;
+      }
+      double u = 1, v = 0;
+      for (size_t i = bound[k + 1]; i-- > bound[k];) {
+        u *= alpha_[i] / 2.0;
+        v = (alpha_[i] * v + beta_[i]) / 2.0;
+      }
+      scale[k] = u;
+      shift[k] = v;
     }
+  });
+  coeff(size, 2) = lastMoment();
+  for (size_t k = parts; k-- > 1;) {
+    coeff(bound[k], 2) = scale[k] * coeff(bound[k + 1], 2) + shift[k];
+  }
+
+  // Likewise the first moment of every partition but the first is set
+  run([this, &bound](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const size_t first = bound[k] + (k > 0 ? 1 : 0);
+      for (size_t i = bound[k + 1] - 1; i >= first; --i) {
+        coeff(i, 2) = (alpha_[i] * coeff(i + 1, 2) + beta_[i]) / 2.0;
+      }
+    }
+  });
+  run([this, &bound](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      updateSegmentRange(bound[k], bound[k + 1] - 1);
+    }
+  });
+  updateSegmentRange(size, size);
+}
+
+void SplineInterpolation::updateSegments(size_t first) {
+  updateSegmentRange(first, points_.size() - 1);
+}
+
+// Segments first..last, taking the moments of first - 1..last as solved
+void SplineInterpolation::updateSegmentRange(size_t first, size_t last) {
+  for (size_t i = last; i >= first && i > 0; --i) {
+    double h = points_[i].first - points_[i - 1].first;
+    coeff(i, 3) = (coeff(i, 2) - coeff(i - 1, 2)) / 3.0 / h;
+    coeff(i, 1) = (2.0 * coeff(i, 2) + coeff(i - 1, 2)) * h / 3.0 +
+                  (coeff(i, 0) - coeff(i - 1, 0)) / h;
   }
 }
 
 double SplineInterpolation::calculateValue(double t) {
-  for (size_t i = 1; i < points_.size(); ++i) {
-    if ((points_[i - 1].first - s21::kEps) < t &&
-        (points_[i].first + s21::kEps) > t) {
-      t -= points_[i].first;
-      return coeff_[i][0] +
-             t * (coeff_[i][1] + coeff_[i][2] * t + coeff_[i][3] * t * t);
+  size_t i = lookup_.find(t);
+  if (i == SegmentLookup::kNotFound) {
+    throw std::invalid_argument("Argument is out of range");
+  }
+  t -= points_[i].first;
+  return coeff(i, 0) + t * (coeff(i, 1) + t * (coeff(i, 2) + t * coeff(i, 3)));
+}
+
+double SplineInterpolation::getDerivative(double t, int order) {
+  double out;
+  evaluateDerivative(&t, &out, 1, order);
+  return out;
+}
+
+void SplineInterpolation::evaluateDerivative(const double* t, double* out,
+                                             size_t count, int order) {
+  if (rows_ == 0) {
+    throw std::domain_error("Error: Spline polynomial not inited");
+  }
+  if (order != 1 && order != 2) {
+    throw std::invalid_argument("Error: derivative order must be 1 or 2");
+  }
+  for (size_t j = 0; j < count; ++j) {
+    size_t i = lookup_.find(t[j]);
+    if (i == SegmentLookup::kNotFound) {
+      throw std::invalid_argument("Argument is out of range");
     }
+    const double dt = t[j] - points_[i].first;
+    if (order == 1) {
+      out[j] = coeff(i, 1) + dt * (2.0 * coeff(i, 2) + 3.0 * dt * coeff(i, 3));
+    } else {
+      out[j] = 2.0 * coeff(i, 2) + 6.0 * dt * coeff(i, 3);
+    }
+  }
+}
+
+double SplineInterpolation::getIntegral(double from, double to) {
+  double out;
+  integrate(&from, &to, &out, 1);
+  return out;
+}
+
+void SplineInterpolation::integrate(const double* from, const double* to,
+                                    double* out, size_t count) {
+  if (rows_ == 0) {
+    throw std::domain_error("Error: Spline polynomial not inited");
+  }
+  if (integral_.empty()) {
+    integral_.push_back(0);
+  }
+  for (size_t i = integral_.size(); i < rows_; ++i) {
+    const double h = points_[i].first - points_[i - 1].first;
+    integral_.push_back(
+        integral_[i - 1] +
+        h * (coeff(i, 0) -
+             h * (coeff(i, 1) / 2.0 -
+                  h * (coeff(i, 2) / 3.0 - h * coeff(i, 3) / 4.0))));
+  }
+  for (size_t j = 0; j < count; ++j) {
+    out[j] = primitive(to[j]) - primitive(from[j]);
+  }
+}
+
+// Integral from the first knot to t: the prefix up to the right knot of
+// the segment, less the part of the segment past t
+double SplineInterpolation::primitive(double t) {
+  size_t i = lookup_.find(t);
+  if (i == SegmentLookup::kNotFound) {
+    throw std::invalid_argument("Argument is out of range");
   }
-  throw std::invalid_argument("Argument is out of range");
+  t -= points_[i].first;
+  return integral_[i] +
+         t * (coeff(i, 0) +
+              t * (coeff(i, 1) / 2.0 +
+                   t * (coeff(i, 2) / 3.0 + t * coeff(i, 3) / 4.0)));
 }
 
 }  //   namespace s21
@@ -5,10 +5,16 @@
 #include <stdexcept>
 #include <vector>
 
+#include "../ThreadPool/thread_pool.h"
 #include "../types.h"
+#include "segment_lookup.h"
+#include "spline_coeff.h"
 
 namespace s21 {
 
+// Default size from which the spline system is solved in parallel
+constexpr size_t kParallelSplineKnots = 1 << 17;
+
 class SplineInterpolation {
  public:
   SplineInterpolation() {}
@@ -19,18 +25,78 @@ class SplineInterpolation {
   void operator=(SplineInterpolation&&) = delete;
 
   auto initCubicSpline(const std::vector<Point>&) -> void;
-  auto initCubicSpline(std::vector<DataPoint>&) -> void;
+  auto initCubicSpline(const TimeSeries&) -> void;
+
+  // Live updates: only the trailing segments are recomputed. The back
+  // substitution stops once the second-order coefficients change by no
+  // more than tolerance * |c|; 0 stops when they no longer change at all,
+  // which keeps the result identical to a full initCubicSpline()
+  auto appendPoint(const Point& point) -> void;
+  auto appendPoints(const std::vector<Point>& points) -> void;
+  auto setAppendTolerance(double tolerance) -> void;
+
+  // Splines of at least threshold knots are solved by partitions on the
+  // pool when it has more than one thread. The moments then agree with
+  // the serial sweep to within about 1e-12 of their largest magnitude;
+  // appends continue from either exactly the same way
+  auto setThreadPool(ThreadPool& pool) -> void { pool_ = &pool; }
+  auto setParallelThreshold(size_t threshold) -> void {
+    parallel_threshold_ = threshold;
+  }
+  auto getParallelThreshold() const -> size_t { return parallel_threshold_; }
 
-  auto getCoeff() -> Matrix&;
+  auto setLayout(CoeffLayout layout) -> void;
+  auto getLayout() const -> CoeffLayout { return layout_; }
+
+  auto getCoeff() const -> SplineCoeffView;
   auto getValue(double t) -> double;
+  auto evaluate(const double* t, double* out, size_t count) -> void;
+
+  // Analytic derivatives, order 1 or 2, straight from the coefficients
+  auto getDerivative(double t, int order = 1) -> double;
+  auto evaluateDerivative(const double* t, double* out, size_t count,
+                          int order = 1) -> void;
+  // Definite integrals from the prefix sums of the segment integrals,
+  // built on the first query and extended after appends; one lookup per
+  // bound
+  auto getIntegral(double from, double to) -> double;
+  auto integrate(const double* from, const double* to, double* out,
+                 size_t count) -> void;
 
  private:
   auto resetCoeff(size_t number) -> void;
+  auto growCoeff(size_t number) -> void;
+  auto resetLookup() -> void;
   auto calculateCoeff() -> void;
+  auto sweepRow(size_t i, double& a, double& b, double& c, double& f) const
+      -> void;
+  auto sweepForward(size_t first) -> void;
+  auto solveParallel() -> void;
+  auto lastMoment() -> double;
+  auto updateSegments(size_t first) -> void;
+  auto updateSegmentRange(size_t first, size_t last) -> void;
   auto calculateValue(double t) -> double;
+  auto primitive(double t) -> double;
+
+  auto coeff(size_t row, size_t col) -> double& {
+    return data_[row * row_stride_ + col * col_stride_];
+  }
 
-  Matrix coeff_{};
+  std::vector<SplineSegment> coeff_{};
+  double* data_{nullptr};
+  size_t rows_{0};
+  size_t row_stride_{kSplineCoeffCount};
+  size_t col_stride_{1};
+  CoeffLayout layout_{CoeffLayout::kSegments};
   std::vector<Point> points_{};
+  std::vector<double> alpha_{};
+  std::vector<double> beta_{};
+  // integral_[i]: integral from the first knot to knot i
+  std::vector<double> integral_{};
+  double append_tolerance_{0};
+  SegmentLookup lookup_{};
+  ThreadPool* pool_{&ThreadPool::GetInstance()};
+  size_t parallel_threshold_{kParallelSplineKnots};
 };
 
 }  //   namespace s21
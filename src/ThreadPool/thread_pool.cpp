@@ -0,0 +1,134 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+namespace {
+
+// Queue of the current thread: its own for a worker, the shared last one
+// for any other caller
+thread_local const ThreadPool *tls_pool = nullptr;
+thread_local size_t tls_index = 0;
+
+}  //   namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+  for (size_t i = 0; i <= threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto &it : workers_) {
+    it.join();
+  }
+}
+
+ThreadPool &ThreadPool::GetInstance() {
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) -
+                         1);
+  return pool;
+}
+
+// Jobs must not throw: chunks still queued refer to job and pending
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             const RangeJob &job) {
+  if (begin >= end) {
+    return;
+  }
+  grain = std::max<size_t>(grain, 1);
+  if (workers_.empty() || end - begin <= grain) {
+    job(begin, end);
+    return;
+  }
+  const size_t self = tls_pool == this ? tls_index : workers_.size();
+  const size_t chunks = (end - begin + grain - 1) / grain;
+  std::atomic<size_t> pending{chunks};
+  // Counted before the push: a running worker may take a chunk at once
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    queued_ += chunks;
+  }
+  for (size_t i = 0; i < chunks; ++i) {
+    Queue &queue = *queues_[(self + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    size_t first = begin + i * grain;
+    queue.tasks.push_back({&job, first, std::min(first + grain, end),
+                           &pending});
+  }
+  sleep_cv_.notify_all();
+  done_cv_.notify_all();
+
+  while (pending.load() > 0) {
+    if (!tryRun(self)) {
+      std::unique_lock<std::mutex> lock(sleep_mtx_);
+      done_cv_.wait(lock,
+                    [this, &pending] { return !pending || queued_ > 0; });
+    }
+  }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+  tls_pool = this;
+  tls_index = index;
+  for (;;) {
+    if (tryRun(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mtx_);
+    sleep_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    if (stop_ && queued_ == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::tryRun(size_t index) {
+  Task task{};
+  if (!pop(index, task) && !steal(index, task)) {
+    return false;
+  }
+  (*task.job)(task.begin, task.end);
+  if (--*task.pending == 0) {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    done_cv_.notify_all();
+  }
+  return true;
+}
+
+bool ThreadPool::pop(size_t index, Task &task) {
+  Queue &queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mtx);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = queue.tasks.back();
+  queue.tasks.pop_back();
+  --queued_;
+  return true;
+}
+
+bool ThreadPool::steal(size_t index, Task &task) {
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    Queue &queue = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    if (!queue.tasks.empty()) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  //  namespace s21
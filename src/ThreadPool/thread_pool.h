@@ -0,0 +1,74 @@
+#ifndef SRC_THREADPOOL_THREAD_POOL_H_
+#define SRC_THREADPOOL_THREAD_POOL_H_
+
+//
+// Persistent work-stealing pool shared by the library. Every worker owns a
+// deque: it takes its own tasks from the back and steals from the front of
+// the others when it runs dry. parallelFor() is a barrier: the calling
+// thread runs tasks too and returns once the whole range is done, so it can
+// also be called from inside a task.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+class ThreadPool {
+ public:
+  using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+  // threads: worker count besides the caller
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  void operator=(const ThreadPool &) = delete;
+  void operator=(ThreadPool &&) = delete;
+
+  // One worker per core besides the caller
+  static ThreadPool &GetInstance();
+
+  // Threads taking part in parallelFor(), the caller included
+  auto size() const -> size_t { return workers_.size() + 1; }
+
+  // Runs job over [begin, end) in chunks of at most grain indices
+  auto parallelFor(size_t begin, size_t end, size_t grain, const RangeJob &job)
+      -> void;
+
+ private:
+  struct Task {
+    const RangeJob *job;
+    size_t begin;
+    size_t end;
+    std::atomic<size_t> *pending;
+  };
+  struct Queue {
+    std::mutex mtx;
+    std::deque<Task> tasks;
+  };
+
+  auto workerLoop(size_t index) -> void;
+  auto tryRun(size_t index) -> bool;
+  auto pop(size_t index, Task &task) -> bool;
+  auto steal(size_t index, Task &task) -> bool;
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mtx_;
+  std::condition_variable sleep_cv_;
+  std::condition_variable done_cv_;
+  std::atomic<size_t> queued_{0};
+  bool stop_{false};
+};
+
+}  //  namespace s21
+
+#endif  //  SRC_THREADPOOL_THREAD_POOL_H_
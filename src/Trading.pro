@@ -10,9 +10,21 @@ CONFIG += c++17
 
 SOURCES += \
     Approximation/approximation.cpp \
+    Approximation/approximation_accumulator.cpp \
     Approximation/gauss.cpp \
+    Approximation/lu_solver.cpp \
+    Approximation/batch_solver.cpp \
+    Approximation/qr_least_squares.cpp \
+    Approximation/rolling_regression.cpp \
+    BarycentricInterpolation/barycentric_interpolation.cpp \
+    CsvLoader/csv_loader.cpp \
+    HermiteInterpolation/hermite_interpolation.cpp \
     NewtonInterpolation/newton_interpolation.cpp \
+    NewtonInterpolation/piecewise_newton.cpp \
+    SplineInterpolation/segment_lookup.cpp \
+    SplineInterpolation/smoothing_spline.cpp \
     SplineInterpolation/spline_interpolation.cpp \
+    ThreadPool/thread_pool.cpp \
     main.cpp \
     mainwindow.cpp \
     model.cpp \
@@ -20,9 +32,22 @@ SOURCES += \
 
 HEADERS += \
     Approximation/approximation.h \
+    Approximation/approximation_accumulator.h \
     Approximation/gauss.h \
+    Approximation/lu_solver.h \
+    Approximation/batch_solver.h \
+    Approximation/qr_least_squares.h \
+    Approximation/rolling_regression.h \
+    BarycentricInterpolation/barycentric_interpolation.h \
+    CsvLoader/csv_loader.h \
+    HermiteInterpolation/hermite_interpolation.h \
     NewtonInterpolation/newton_interpolation.h \
+    NewtonInterpolation/piecewise_newton.h \
+    SplineInterpolation/segment_lookup.h \
+    SplineInterpolation/smoothing_spline.h \
+    SplineInterpolation/spline_coeff.h \
     SplineInterpolation/spline_interpolation.h \
+    ThreadPool/thread_pool.h \
     controller.h \
     mainwindow.h \
     model.h \
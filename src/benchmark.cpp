@@ -0,0 +1,940 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+
+#include "model.h"
+
+//
+// Throughput benchmarks, run with `make bench`.
+// Pass a section name (e.g. `./benchmark loader`) to run only that section.
+//
+
+const std::string kDataSet = "./datasets/";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Repeats the job until at least kMinTime is spent, returns seconds per run
+double measure(const std::function<void()>& job) {
+  constexpr double kMinTime = 0.2;
+  size_t runs = 0;
+  double elapsed = 0;
+  auto start = Clock::now();
+  do {
+    job();
+    ++runs;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < kMinTime);
+  return elapsed / runs;
+}
+
+size_t fileSize(const std::string& file) {
+  std::ifstream fp(file, std::ios::binary | std::ios::ate);
+  return fp.is_open() ? static_cast<size_t>(fp.tellg()) : 0;
+}
+
+void benchLoader() {
+  const char* files[] = {"AAPL.csv", "ADBE.csv", "CVX.csv", "DPZ.csv",
+                         "F.csv",    "sin.csv",  "x2.csv"};
+  std::cout << "CSV loader throughput, MB/s\n"
+            << std::setw(12) << "file" << std::setw(12) << "stream"
+            << std::setw(12) << "mapped" << std::setw(10) << "speedup\n";
+  for (auto name : files) {
+    std::string file = kDataSet + name;
+    double mb = fileSize(file) / 1e6;
+    double time[2]{};
+    s21::LoadMode modes[2]{s21::LoadMode::kStream, s21::LoadMode::kMapped};
+    for (int i = 0; i < 2; ++i) {
+      time[i] = measure([&file, &modes, i]() {
+        s21::Model model;
+        model.loadFromFile(file, modes[i]);
+      });
+    }
+    std::cout << std::setw(12) << name << std::fixed << std::setprecision(1)
+              << std::setw(12) << mb / time[0] << std::setw(12) << mb / time[1]
+              << std::setw(9) << time[0] / time[1] << "x\n";
+  }
+}
+
+// Minute bars, either without gaps or with random ones
+std::vector<s21::Point> makeKnots(size_t count, bool uniform) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> gap(0.5, 3.0), price(-1.0, 1.0);
+  std::vector<s21::Point> points(count);
+  double t = 1.6e9, value = 100;
+  for (auto& it : points) {
+    it = {t, value += price(gen)};
+    t += uniform ? 60 : gap(gen) * 60;
+  }
+  return points;
+}
+
+// Former SplineInterpolation::calculateValue segment search
+size_t linearFind(const std::vector<s21::Point>& points, double t) {
+  for (size_t i = 1; i < points.size(); ++i) {
+    if ((points[i - 1].first - s21::kEps) < t &&
+        (points[i].first + s21::kEps) > t) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+void benchLookup() {
+  std::cout << "Spline evaluation, ns per point (M = 10 N sweep)\n"
+            << std::setw(10) << "knots" << std::setw(12) << "linear"
+            << std::setw(12) << "uniform" << std::setw(12) << "sweep"
+            << std::setw(12) << "random\n";
+  for (size_t n : {100, 1000, 10000, 100000, 1000000}) {
+    const size_t m = 10 * n;
+    std::vector<double> sweep[2], shuffled;
+    double ns[4]{};
+    for (int uniform = 1; uniform >= 0; --uniform) {
+      auto points = makeKnots(n, uniform);
+      s21::SplineInterpolation spline;
+      spline.initCubicSpline(points);
+      double step = (points.back().first - points.front().first) / (m - 1);
+      auto& queries = sweep[uniform];
+      for (size_t i = 0; i < m; ++i) {
+        queries.push_back(
+            std::min(points.front().first + i * step, points.back().first));
+      }
+      double sum = 0;
+      double time = measure([&spline, &queries, &sum]() {
+        for (double t : queries) sum += spline.getValue(t);
+      });
+      ns[uniform ? 1 : 2] = time / m * 1e9;
+      if (!uniform) {
+        shuffled = queries;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+        time = measure([&spline, &shuffled, &sum]() {
+          for (double t : shuffled) sum += spline.getValue(t);
+        });
+        ns[3] = time / m * 1e9;
+        if (n <= 10000) {
+          size_t probes = std::min<size_t>(m, 20000);
+          time = measure([&points, &queries, &sum, probes, m]() {
+            for (size_t i = 0; i < probes; ++i) {
+              sum += linearFind(points, queries[i * (m / probes)]);
+            }
+          });
+          ns[0] = time / probes * 1e9;
+        }
+      }
+      if (sum == 0.123) std::cout << sum;
+    }
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1);
+    if (ns[0] > 0) {
+      std::cout << std::setw(12) << ns[0];
+    } else {
+      std::cout << std::setw(12) << "-";
+    }
+    std::cout << std::setw(12) << ns[1] << std::setw(12) << ns[2]
+              << std::setw(11) << ns[3] << "\n";
+  }
+}
+
+void benchBatch() {
+  constexpr size_t kKnots = 2000, kPoints = 200000;
+  auto points = makeKnots(kKnots, false);
+  std::vector<double> t(kPoints), out;
+  double step = (points.back().first - points.front().first) / (kPoints - 1);
+  for (size_t i = 0; i < kPoints; ++i) {
+    t[i] = std::min(points.front().first + i * step, points.back().first);
+  }
+  std::vector<s21::Point> segment(points.begin(), points.begin() + 8);
+  std::vector<double> t_segment;
+  for (double x : t) {
+    if (x <= segment.back().first) t_segment.push_back(x);
+  }
+
+  s21::Model model;
+  model.initCubicSpline(points);
+  model.initNewtonPolynomial(segment);
+  model.initApproximation(points, 10);
+
+  struct Case {
+    const char* name;
+    const std::vector<double>* t;
+    double (s21::Model::*scalar)(double);
+    void (s21::Model::*batch)(const std::vector<double>&, std::vector<double>&);
+  };
+  const Case cases[] = {
+      {"spline", &t, &s21::Model::getSplineValue, &s21::Model::getSplineValues},
+      {"newton(7)", &t_segment, &s21::Model::getNewtonValue,
+       &s21::Model::getNewtonValues},
+      {"approx(10)", &t, &s21::Model::getApproxValue,
+       &s21::Model::getApproxValues}};
+
+  std::cout << "Scalar vs batch evaluation, ns per point\n"
+            << std::setw(12) << "method" << std::setw(12) << "scalar"
+            << std::setw(12) << "batch" << std::setw(10) << "speedup\n";
+  for (auto& it : cases) {
+    const std::vector<double>& x = *it.t;
+    double sum = 0;
+    double scalar = measure([&model, &x, &it, &sum]() {
+      for (double v : x) sum += (model.*it.scalar)(v);
+    });
+    double batch = measure([&model, &x, &it, &out]() {
+      (model.*it.batch)(x, out);
+    });
+    if (sum == 0.123) std::cout << sum;
+    std::cout << std::setw(12) << it.name << std::fixed << std::setprecision(1)
+              << std::setw(12) << scalar / x.size() * 1e9 << std::setw(12)
+              << batch / x.size() * 1e9 << std::setw(9) << scalar / batch
+              << "x\n";
+  }
+}
+
+void benchAppend() {
+  std::cout << "Spline live update, us per new bar\n"
+            << std::setw(10) << "knots" << std::setw(12) << "re-init"
+            << std::setw(12) << "append" << std::setw(10) << "speedup\n";
+  for (size_t n : {1000, 10000, 100000, 1000000}) {
+    constexpr size_t kTicks = 1000;
+    auto points = makeKnots(n + kTicks, false);
+    std::vector<s21::Point> history(points.begin(), points.begin() + n);
+    s21::SplineInterpolation spline;
+    double reinit = measure([&spline, &history]() {
+      spline.initCubicSpline(history);
+    });
+    spline.initCubicSpline(history);
+    auto start = Clock::now();
+    for (size_t i = n; i < n + kTicks; ++i) {
+      spline.appendPoint(points[i]);
+    }
+    double append =
+        std::chrono::duration<double>(Clock::now() - start).count() / kTicks;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << reinit * 1e6 << std::setw(12) << append * 1e6
+              << std::setw(9) << std::setprecision(0) << reinit / append
+              << "x\n";
+  }
+}
+
+void benchSmoothing() {
+  std::cout << "Smoothing spline, ms per fit\n"
+            << std::setw(10) << "knots" << std::setw(12) << "fixed"
+            << std::setw(12) << "gcv" << std::setw(12) << "per knot\n";
+  for (size_t n : {1000, 10000, 100000, 1000000}) {
+    auto points = makeKnots(n, false);
+    s21::SmoothingSpline spline;
+    double fixed = measure([&spline, &points]() {
+      spline.initSmoothingSpline(points);
+    });
+    spline.setAutoSmoothing(true);
+    double gcv = measure([&spline, &points]() {
+      spline.initSmoothingSpline(points);
+    });
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << fixed * 1e3 << std::setw(12) << gcv * 1e3
+              << std::setw(10) << gcv / n * 1e9 << "ns\n";
+  }
+}
+
+void benchHermite() {
+  std::cout << "PCHIP vs cubic spline: build ms, us per new bar\n"
+            << std::setw(10) << "knots" << std::setw(12) << "spline"
+            << std::setw(12) << "pchip" << std::setw(12) << "spl.append"
+            << std::setw(12) << "pch.append\n";
+  for (size_t n : {10000, 100000, 1000000}) {
+    constexpr size_t kTicks = 1000;
+    auto points = makeKnots(n + kTicks, false);
+    std::vector<s21::Point> history(points.begin(), points.begin() + n);
+    s21::SplineInterpolation spline;
+    s21::HermiteInterpolation hermite;
+    double t_spline = measure([&spline, &history]() {
+      spline.initCubicSpline(history);
+    });
+    double t_hermite = measure([&hermite, &history]() {
+      hermite.initHermiteSpline(history);
+    });
+    spline.initCubicSpline(history);
+    hermite.initHermiteSpline(history);
+    auto start = Clock::now();
+    for (size_t i = n; i < n + kTicks; ++i) {
+      spline.appendPoint(points[i]);
+    }
+    auto middle = Clock::now();
+    for (size_t i = n; i < n + kTicks; ++i) {
+      hermite.appendPoint(points[i]);
+    }
+    auto stop = Clock::now();
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << t_spline * 1e3 << std::setw(12)
+              << t_hermite * 1e3 << std::setw(12)
+              << std::chrono::duration<double>(middle - start).count() /
+                     kTicks * 1e6
+              << std::setw(12)
+              << std::chrono::duration<double>(stop - middle).count() /
+                     kTicks * 1e6
+              << "\n";
+  }
+}
+
+void benchCalculus() {
+  std::cout << "Spline slope and area, ns per query\n"
+            << std::setw(10) << "knots" << std::setw(12) << "fin.diff"
+            << std::setw(12) << "analytic" << std::setw(12) << "trapezoid"
+            << std::setw(12) << "prefix\n";
+  for (size_t n : {1000, 100000, 1000000}) {
+    constexpr size_t kQueries = 100000;
+    constexpr size_t kSteps = 64;
+    auto points = makeKnots(n, false);
+    s21::SplineInterpolation spline;
+    spline.initCubicSpline(points);
+    const double lo = points.front().first, hi = points.back().first;
+    std::vector<double> t(kQueries), from(kQueries), to(kQueries);
+    std::vector<double> out(kQueries), shifted(kQueries);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(lo + 1, hi - 1);
+    for (size_t i = 0; i < kQueries; ++i) {
+      t[i] = dist(gen);
+      from[i] = dist(gen);
+      to[i] = std::min(hi, from[i] + (hi - lo) / 100);
+    }
+    double diff = measure([&]() {
+      const double h = 1e-3;
+      for (size_t i = 0; i < kQueries; ++i) shifted[i] = t[i] + h;
+      spline.evaluate(shifted.data(), out.data(), kQueries);
+      for (size_t i = 0; i < kQueries; ++i) shifted[i] = t[i] - h;
+      spline.evaluate(shifted.data(), shifted.data(), kQueries);
+      for (size_t i = 0; i < kQueries; ++i) {
+        out[i] = (out[i] - shifted[i]) / (2 * h);
+      }
+    });
+    double analytic = measure([&]() {
+      spline.evaluateDerivative(t.data(), out.data(), kQueries);
+    });
+    double trapezoid = measure([&]() {
+      for (size_t i = 0; i < kQueries / kSteps; ++i) {
+        const double h = (to[i] - from[i]) / kSteps;
+        double sum = 0;
+        for (size_t k = 0; k <= kSteps; ++k) {
+          sum += (k == 0 || k == kSteps ? 0.5 : 1.0) *
+                 spline.getValue(from[i] + k * h);
+        }
+        out[i] = sum * h;
+      }
+    }) * kSteps;
+    double prefix = measure([&]() {
+      spline.integrate(from.data(), to.data(), out.data(), kQueries);
+    });
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << diff / kQueries * 1e9 << std::setw(12)
+              << analytic / kQueries * 1e9 << std::setw(12)
+              << trapezoid / kQueries * 1e9 << std::setw(12)
+              << prefix / kQueries * 1e9 << "\n";
+  }
+}
+
+void benchTridiag() {
+  std::cout << "Spline system, ms per solve\n"
+            << std::setw(10) << "knots" << std::setw(12) << "serial"
+            << std::setw(12) << "parallel" << std::setw(10) << "speedup\n";
+  for (size_t n : {10000, 100000, 1000000, 4000000}) {
+    auto points = makeKnots(n, false);
+    s21::SplineInterpolation serial, parallel;
+    serial.setParallelThreshold(std::numeric_limits<size_t>::max());
+    parallel.setParallelThreshold(0);
+    double t_serial = measure([&serial, &points]() {
+      serial.initCubicSpline(points);
+    });
+    double t_parallel = measure([&parallel, &points]() {
+      parallel.initCubicSpline(points);
+    });
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << t_serial * 1e3 << std::setw(12)
+              << t_parallel * 1e3 << std::setw(9) << std::setprecision(2)
+              << t_serial / t_parallel << "x\n";
+  }
+}
+
+// Former NewtonInterpolation::calculateCoeff: every coefficient from the
+// partial polynomial value at the next node
+std::vector<double> legacyNewton(const std::vector<s21::Point>& points) {
+  std::vector<double> coeff{points[0].second};
+  for (size_t i = 1; i < points.size(); ++i) {
+    double p = 1.0, value = coeff[0], q = 1.0;
+    for (size_t j = 0; j < i; ++j) {
+      p *= points[i].first - points[j].first;
+    }
+    for (size_t j = 1; j < i; ++j) {
+      q *= points[i].first - points[j - 1].first;
+      value += coeff[j] * q;
+    }
+    coeff.push_back((points[i].second - value) / p);
+  }
+  return coeff;
+}
+
+// Max |P(x) - y| over the nodes, relative to max |y|
+double nodeResidual(const std::vector<s21::Point>& points,
+                    const std::vector<double>& coeff) {
+  double residual = 0, scale = 0;
+  for (auto& it : points) {
+    double value = coeff.back();
+    for (size_t k = coeff.size() - 1; k-- > 0;) {
+      value = value * (it.first - points[k].first) + coeff[k];
+    }
+    residual = std::max(residual, std::fabs(value - it.second));
+    scale = std::max(scale, std::fabs(it.second));
+  }
+  return residual / scale;
+}
+
+void benchNewton() {
+  std::cout << "Newton coefficients: build time (ns) and node residual\n"
+            << std::setw(8) << "degree" << std::setw(12) << "legacy"
+            << std::setw(12) << "table" << std::setw(12) << "addNode"
+            << std::setw(14) << "legacy err" << std::setw(14) << "table err\n";
+  for (size_t degree : {1, 2, 4, 8, 16, 32, 64}) {
+    std::vector<s21::Point> points;
+    for (size_t i = 0; i <= degree; ++i) {
+      points.push_back({i + 0.0, 100 + 10 * std::sin(i / 3.0)});
+    }
+    std::vector<double> legacy;
+    s21::NewtonInterpolation newton;
+    double time[4]{};
+    time[0] = measure([&legacy, &points]() { legacy = legacyNewton(points); });
+    time[1] = measure([&newton, &points]() {
+      newton.initNewtonPolynomial(points);
+    });
+    time[2] = measure([&newton, &points]() {
+      newton.initNewtonPolynomial({points.front()});
+      for (size_t i = 1; i < points.size(); ++i) newton.addNode(points[i]);
+    });
+    newton.initNewtonPolynomial(points);
+    std::cout << std::setw(8) << degree << std::fixed << std::setprecision(0)
+              << std::setw(12) << time[0] * 1e9 << std::setw(12)
+              << time[1] * 1e9 << std::setw(12) << time[2] * 1e9
+              << std::scientific << std::setprecision(2) << std::setw(14)
+              << nodeResidual(points, legacy) << std::setw(14)
+              << nodeResidual(points, newton.getCoeff()) << "\n"
+              << std::defaultfloat;
+  }
+}
+
+void benchPiecewise() {
+  constexpr size_t kKnots = 100000, kQueries = 2000, kDegree = 5;
+  auto points = makeKnots(kKnots, false);
+  std::vector<double> t(kQueries), out(kQueries);
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(points.front().first,
+                                              points.back().first);
+  for (auto& it : t) it = dist(gen);
+
+  // Former MainWindow::calculateNewton: slice the segment and rebuild it
+  s21::NewtonInterpolation newton;
+  double legacy = measure([&points, &t, &out, &newton]() {
+    std::vector<s21::Point> segment;
+    for (size_t q = 0; q < t.size(); ++q) {
+      segment.clear();
+      for (size_t i = 0; i < points.size() - 1; i += kDegree) {
+        if (i + kDegree < points.size()) {
+          if (points[i].first - s21::kEps < t[q] &&
+              points[i + kDegree].first + s21::kEps > t[q]) {
+            segment.assign(points.begin() + i,
+                           points.begin() + i + kDegree + 1);
+            break;
+          }
+        } else {
+          segment.assign(points.end() - kDegree - 1, points.end());
+        }
+      }
+      newton.initNewtonPolynomial(segment);
+      out[q] = newton.getValue(t[q]);
+    }
+  });
+
+  s21::PiecewiseNewton piecewise;
+  double build = measure([&points, &piecewise]() {
+    piecewise.init(points, kDegree);
+  });
+  double parallel = measure([&points, &piecewise]() {
+    piecewise.init(points, kDegree, 0);
+  });
+  double query = measure([&t, &out, &piecewise]() {
+    piecewise.evaluate(t.data(), out.data(), t.size());
+  });
+
+  std::cout << "Piecewise Newton, " << kKnots << " points, degree " << kDegree
+            << "\n"
+            << std::fixed << std::setprecision(3)
+            << "  per-query rebuild:  " << legacy / kQueries * 1e6
+            << " us/query\n"
+            << "  build, 1 thread:    " << build * 1e3 << " ms\n"
+            << "  build, all cores:   " << parallel * 1e3 << " ms\n"
+            << "  prebuilt query:     " << query / kQueries * 1e6
+            << " us/query\n"
+            << std::defaultfloat;
+}
+
+void benchBarycentric() {
+  constexpr size_t kPoints = 100000;
+  std::cout << "Newton vs barycentric form, batch ns per point and max "
+               "difference\n"
+            << std::setw(8) << "degree" << std::setw(12) << "newton"
+            << std::setw(14) << "barycentric" << std::setw(14) << "difference"
+            << "\n";
+  for (size_t degree : {4, 8, 16, 32}) {
+    std::vector<s21::Point> points;
+    for (size_t i = 0; i <= degree; ++i) {
+      points.push_back({60.0 * i, 100 + 10 * std::sin(i / 3.0)});
+    }
+    std::vector<double> t(kPoints), newton_out(kPoints), bary_out(kPoints);
+    for (size_t i = 0; i < kPoints; ++i) {
+      t[i] = points.back().first * (i + 0.5) / kPoints;
+    }
+    s21::NewtonInterpolation newton;
+    s21::BarycentricInterpolation barycentric;
+    newton.initNewtonPolynomial(points);
+    barycentric.initBarycentricPolynomial(points);
+    double time[2]{};
+    time[0] = measure([&newton, &t, &newton_out]() {
+      newton.evaluate(t.data(), newton_out.data(), t.size());
+    });
+    time[1] = measure([&barycentric, &t, &bary_out]() {
+      barycentric.evaluate(t.data(), bary_out.data(), t.size());
+    });
+    double difference = 0;
+    for (size_t i = 0; i < kPoints; ++i) {
+      difference = std::max(difference, std::fabs(newton_out[i] - bary_out[i]));
+    }
+    std::cout << std::setw(8) << degree << std::fixed << std::setprecision(2)
+              << std::setw(12) << time[0] / kPoints * 1e9 << std::setw(14)
+              << time[1] / kPoints * 1e9 << std::scientific
+              << std::setprecision(2) << std::setw(14) << difference << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// Former Approximation::calculateMatrixSLAE: one pow() per point, power
+// and matrix entry
+s21::Matrix legacyNormalEquations(const std::vector<s21::Point>& points,
+                                  int degree) {
+  s21::Matrix slae(degree + 1, std::vector<double>(degree + 2));
+  for (int i = 0; i < degree + 1; ++i) {
+    for (int j = i; j < degree + 1; ++j) {
+      double sum = 0;
+      for (auto& it : points) sum += pow(it.first, i + j);
+      slae[i][j] = slae[j][i] = sum;
+    }
+  }
+  for (int i = 0; i < degree + 1; ++i) {
+    for (auto& it : points) slae[i][degree + 1] += it.second * pow(it.first, i);
+  }
+  return slae;
+}
+
+void benchApprox() {
+  constexpr size_t kLegacyLimit = 100000;
+  std::cout << "Least squares fit, ms per init (legacy: normal equations "
+               "only)\n"
+            << std::setw(10) << "points" << std::setw(8) << "degree"
+            << std::setw(12) << "legacy" << std::setw(12) << "single pass"
+            << "\n";
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> noise(-0.1, 0.1);
+  for (size_t count : {100000, 1000000, 10000000}) {
+    std::vector<s21::Point> points(count);
+    for (size_t i = 0; i < count; ++i) {
+      double x = 2.0 * i / count;
+      points[i] = {x, std::sin(3 * x) + noise(gen)};
+    }
+    for (int degree : {1, 2, 5, 10, 20}) {
+      s21::Approximation approx;
+      double legacy = 0;
+      if (count <= kLegacyLimit) {
+        legacy = measure([&points, degree]() {
+          legacyNormalEquations(points, degree);
+        });
+      }
+      double time = measure([&approx, &points, degree]() {
+        approx.initApproximation(points, degree);
+      });
+      std::cout << std::setw(10) << count << std::setw(8) << degree
+                << std::fixed << std::setprecision(2) << std::setw(12);
+      if (count <= kLegacyLimit) {
+        std::cout << legacy * 1e3;
+      } else {
+        std::cout << "-";
+      }
+      std::cout << std::setw(12) << time * 1e3 << "\n" << std::defaultfloat;
+    }
+  }
+}
+
+// Both least squares backends on daily epoch-second quotes: ms per fit and
+// the largest deviation from the smooth series they fit
+void benchApproxQr() {
+  constexpr size_t kCount = 100000;
+  std::cout << "Least squares backends, " << kCount << " daily points\n"
+            << std::setw(8) << "degree" << std::setw(12) << "normal ms"
+            << std::setw(12) << "qr ms" << std::setw(14) << "normal err"
+            << std::setw(12) << "qr err" << "\n";
+  s21::TimeSeries data;
+  for (size_t i = 0; i < kCount; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay,
+                   100 + 10 * std::sin(2.0 * i / kCount));
+  }
+  for (int degree : {2, 5, 10, 20}) {
+    double time[2]{}, error[2]{};
+    for (int method = 0; method < 2; ++method) {
+      s21::Approximation approx;
+      approx.setMethod(method ? s21::ApproxMethod::kQr
+                              : s21::ApproxMethod::kNormalEquations);
+      time[method] = measure([&approx, &data, degree]() {
+        approx.initApproximation(data, degree);
+      });
+      error[method] = INFINITY;
+      if (approx.getCoeff().empty()) continue;
+      error[method] = 0;
+      for (size_t i = 0; i < kCount; i += 97) {
+        double value = approx.getValue(data.time[i]);
+        error[method] = std::max(error[method],
+                                 std::fabs(value - data.value[i]));
+        if (std::isnan(value)) error[method] = INFINITY;
+      }
+    }
+    std::cout << std::setw(8) << degree << std::fixed << std::setprecision(2)
+              << std::setw(12) << time[0] * 1e3 << std::setw(12)
+              << time[1] * 1e3 << std::scientific << std::setprecision(2)
+              << std::setw(14) << error[0] << std::setw(12) << error[1]
+              << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// The GUI degree sweep 1..20: a refit per degree against one orthogonal
+// fit and selectDegree() for the rest, and the auto degree that also
+// scores each degree by leave-one-out error
+void benchSweep() {
+  constexpr int kMaxDegree = 20;
+  std::cout << "Degree sweep 1.." << kMaxDegree << ", ms per sweep\n"
+            << std::setw(10) << "points" << std::setw(12) << "normal"
+            << std::setw(12) << "qr" << std::setw(12) << "orthogonal"
+            << std::setw(12) << "auto" << "\n";
+  for (size_t count : {1000, 10000, 100000}) {
+    s21::TimeSeries data;
+    for (size_t i = 0; i < count; ++i) {
+      data.push_back(1600000000 + i * s21::kSecInDay,
+                     100 + 10 * std::sin(2.0 * i / count));
+    }
+    double time[4]{};
+    const s21::ApproxMethod methods[] = {s21::ApproxMethod::kNormalEquations,
+                                         s21::ApproxMethod::kQr,
+                                         s21::ApproxMethod::kOrthogonal};
+    for (int m = 0; m < 3; ++m) {
+      s21::Approximation approx;
+      approx.setMethod(methods[m]);
+      std::streambuf* err = std::cerr.rdbuf(nullptr);
+      const bool orthogonal = methods[m] == s21::ApproxMethod::kOrthogonal;
+      time[m] = measure([&approx, &data, orthogonal]() {
+        if (orthogonal) {
+          approx.initApproximation(data, kMaxDegree);
+          for (int d = 1; d <= kMaxDegree; ++d) approx.selectDegree(d);
+        } else {
+          for (int d = 1; d <= kMaxDegree; ++d) {
+            approx.initApproximation(data, d);
+          }
+        }
+      });
+      std::cerr.rdbuf(err);
+    }
+    s21::Approximation automatic;
+    automatic.setAutoDegree(true);
+    time[3] = measure([&automatic, &data]() {
+      automatic.initApproximation(data, kMaxDegree);
+    });
+    std::cout << std::setw(10) << count << std::fixed << std::setprecision(2)
+              << std::setw(12) << time[0] * 1e3 << std::setw(12)
+              << time[1] * 1e3 << std::setw(12) << time[2] * 1e3
+              << std::setw(12) << time[3] * 1e3 << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// A new bar on top of a long history: initApproximation over everything
+// against one accumulator add() and a solve
+void benchOnline() {
+  constexpr int kDegree = 5;
+  std::cout << "Online fit, degree " << kDegree << ", us per new bar\n"
+            << std::setw(10) << "history" << std::setw(12) << "refit"
+            << std::setw(14) << "accumulator" << "\n";
+  for (size_t count : {1000, 10000, 100000}) {
+    s21::TimeSeries data;
+    for (size_t i = 0; i < count; ++i) {
+      data.push_back(1600000000 + i * s21::kSecInDay,
+                     100 + 10 * std::sin(2.0 * i / count));
+    }
+    s21::Approximation approx;
+    approx.setMethod(s21::ApproxMethod::kQr);
+    double refit = measure([&approx, &data]() {
+      approx.initApproximation(data, kDegree);
+    });
+    s21::ApproximationAccumulator acc(kDegree, data.time.front(),
+                                      1.0 / s21::kSecInDay);
+    acc.add(data);
+    double online = measure([&acc, &data]() {
+      acc.add(data.time.back(), data.value.back());
+      acc.remove(data.time.back(), data.value.back());
+      acc.getCoeff();
+    });
+    std::cout << std::setw(10) << count << std::fixed << std::setprecision(2)
+              << std::setw(12) << refit * 1e6 << std::setw(14)
+              << online * 1e6 << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// Backtest forecasts over every window: initApproximation per window
+// against RollingRegression on one thread and on the pool
+void benchRolling() {
+  constexpr size_t kCount = 20000;
+  constexpr int kDegree = 3;
+  s21::ThreadPool& shared = s21::ThreadPool::GetInstance();
+  std::cout << "Rolling fit, degree " << kDegree << ", " << kCount
+            << " points, ms per series, pool of " << shared.size()
+            << " threads\n"
+            << std::setw(8) << "window" << std::setw(12) << "refit"
+            << std::setw(12) << "rolling" << std::setw(12) << "pool"
+            << "\n";
+  s21::TimeSeries data;
+  for (size_t i = 0; i < kCount; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay,
+                   100 + 10 * std::sin(0.01 * i));
+  }
+  for (size_t window : {20, 100, 500}) {
+    std::vector<double> out;
+    double refit = measure([&data, &out, window]() {
+      s21::Approximation approx;
+      s21::TimeSeries part;
+      out.resize(kCount - window);
+      for (size_t i = 0; i + window < kCount; ++i) {
+        part.clear();
+        for (size_t j = i; j < i + window; ++j) {
+          part.push_back(data.time[j], data.value[j]);
+        }
+        approx.initApproximation(part, kDegree);
+        out[i] = approx.getValue(data.time[i + window]);
+      }
+    });
+    s21::RollingRegression rolling(kDegree, window);
+    double serial = measure([&rolling, &data, &out]() {
+      rolling.forecast(data, out);
+    });
+    rolling.setThreadPool(&shared);
+    double pool = measure([&rolling, &data, &out]() {
+      rolling.forecast(data, out);
+    });
+    std::cout << std::setw(8) << window << std::fixed << std::setprecision(2)
+              << std::setw(12) << refit * 1e3 << std::setw(12)
+              << serial * 1e3 << std::setw(12) << pool * 1e3 << "\n"
+              << std::defaultfloat;
+  }
+}
+
+s21::Matrix makeSlae(size_t n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  s21::Matrix matrix(n, std::vector<double>(n + 1));
+  for (size_t i = 0; i < n; ++i) {
+    for (auto& it : matrix[i]) it = dist(gen);
+    matrix[i][i] += n;
+  }
+  return matrix;
+}
+
+void benchSolver() {
+  std::cout << "Gauss::getResultSLAE, ms per solve\n"
+            << std::setw(8) << "n" << std::setw(14) << "elimination"
+            << std::setw(12) << "pivoted LU" << "\n";
+  for (size_t n : {10, 50, 200, 500}) {
+    s21::Matrix matrix = makeSlae(n, 3);
+    s21::Gauss gauss;
+    double time[2]{};
+    gauss.setMode(s21::SlaeMode::kElimination);
+    time[0] = measure([&gauss, &matrix]() { gauss.getResultSLAE(matrix); });
+    gauss.setMode(s21::SlaeMode::kPivotedLu);
+    time[1] = measure([&gauss, &matrix]() { gauss.getResultSLAE(matrix); });
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(3)
+              << std::setw(14) << time[0] * 1e3 << std::setw(12)
+              << time[1] * 1e3 << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// Normal equations of many small fits: a fresh Gauss per system, as
+// Approximation::calculateCoeff used to, against one solveBatch() call
+void benchSmallSlae() {
+  constexpr size_t kCount = 1000;
+  std::cout << "Small SLAE, ns per system, " << kCount << " systems\n"
+            << std::setw(8) << "n" << std::setw(12) << "Gauss"
+            << std::setw(12) << "batch" << "\n";
+  for (size_t n : {2, 3, 6, 11, 21}) {
+    std::vector<s21::Matrix> systems;
+    std::vector<double> a(kCount * n * n), b(kCount * n), x(kCount * n);
+    for (size_t s = 0; s < kCount; ++s) {
+      systems.push_back(makeSlae(n, s));
+      for (size_t i = 0; i < n; ++i) {
+        std::copy(systems[s][i].begin(), systems[s][i].begin() + n,
+                  a.begin() + (s * n + i) * n);
+        b[s * n + i] = systems[s][i][n];
+      }
+    }
+    double gauss = measure([&systems]() {
+      for (auto& it : systems) {
+        s21::Gauss solver;
+        solver.getResultSLAE(it);
+      }
+    });
+    double batch = measure([&a, &b, &x, n]() {
+      s21::solveBatch(a.data(), b.data(), x.data(), n, kCount);
+    });
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << gauss / kCount * 1e9 << std::setw(12)
+              << batch / kCount * 1e9 << "\n"
+              << std::defaultfloat;
+  }
+}
+
+// Former Gauss::calculateGaussParallels: one std::thread per row update
+void legacyThreadElimination(s21::Matrix& matrix) {
+  const int rows = matrix.size(), cols = rows + 1;
+  const int num_threads = std::max(1u, std::thread::hardware_concurrency());
+  auto update = [&matrix, cols](int row, int k) {
+    double coff = matrix[row][k] / matrix[k][k];
+    for (int j = k; j < cols; ++j) matrix[row][j] -= matrix[k][j] * coff;
+  };
+  std::vector<std::thread> threads;
+  for (int k = 0; k < rows - 1; ++k) {
+    for (int i = k + 1; i < rows; ++i) {
+      threads.emplace_back(update, i, k);
+      if (static_cast<int>(threads.size()) == num_threads) {
+        for (auto& it : threads) it.join();
+        threads.clear();
+      }
+    }
+    for (auto& it : threads) it.join();
+    threads.clear();
+  }
+}
+
+void benchPool() {
+  constexpr size_t kLegacyLimit = 200;
+  std::cout << "Gauss elimination, ms per solve, pool of "
+            << s21::ThreadPool::GetInstance().size() << " threads\n"
+            << std::setw(8) << "n" << std::setw(12) << "serial"
+            << std::setw(12) << "pool" << std::setw(16) << "thread per row"
+            << "\n";
+  const std::string file = "/tmp/s21_bench_slae.txt";
+  size_t crossover = 0;
+  for (size_t n : {50, 100, 200, 400, 800}) {
+    s21::Matrix matrix = makeSlae(n, 5);
+    {
+      std::ofstream out(file);
+      out << n << "\n" << std::setprecision(17);
+      for (auto& row : matrix) {
+        for (size_t j = 0; j <= n; ++j) out << row[j] << (j < n ? " " : "\n");
+      }
+    }
+    s21::Gauss gauss;
+    gauss.loadFromFile(file);
+    double serial = measure([&gauss]() {
+      gauss.getResultWithoutParallelAlgo();
+    });
+    double pool = measure([&gauss]() { gauss.getResultWithParallelAlgo(); });
+    if (!crossover && pool < 0.9 * serial) crossover = n;
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << serial * 1e3 << std::setw(12) << pool * 1e3
+              << std::setw(16);
+    if (n <= kLegacyLimit) {
+      std::cout << measure([&matrix]() {
+        s21::Matrix copy = matrix;
+        legacyThreadElimination(copy);
+      }) * 1e3;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << "\n" << std::defaultfloat;
+  }
+  std::remove(file.c_str());
+  if (crossover) {
+    std::cout << "pool beats serial from n = " << crossover << "\n";
+  } else {
+    std::cout << "no crossover up to n = 800\n";
+  }
+}
+
+// LuSolver factorization alone; GFLOP/s taken as 2/3 n^3 per factorization
+void benchBlockedLu() {
+  s21::ThreadPool& shared = s21::ThreadPool::GetInstance();
+  std::cout << "LuSolver::factorize, GFLOP/s, pool of " << shared.size()
+            << " threads\n"
+            << std::setw(8) << "n" << std::setw(10) << "plain"
+            << std::setw(10) << "blocked" << std::setw(10) << "pool"
+            << "\n";
+  for (size_t n : {250, 500, 1000, 2000}) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> a(n * n);
+    for (auto& it : a) it = dist(gen);
+    const double flops = 2.0 / 3.0 * n * n * n;
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(2);
+    for (int variant = 0; variant < 3; ++variant) {
+      s21::LuSolver lu;
+      lu.setBlockSize(variant ? 64 : 0);
+      lu.setThreadPool(variant == 2 ? &shared : nullptr);
+      double time = measure([&lu, &a, n]() {
+        lu.factorize(std::vector<double>(a), n);
+      });
+      std::cout << std::setw(10) << flops / time * 1e-9;
+    }
+    std::cout << "\n" << std::defaultfloat;
+  }
+}
+
+}  //   namespace
+
+int main(int argc, char* argv[]) {
+  const std::pair<const char*, void (*)()> sections[] = {
+      {"loader", benchLoader},
+      {"lookup", benchLookup},
+      {"batch", benchBatch},
+      {"append", benchAppend},
+      {"tridiag", benchTridiag},
+      {"calculus", benchCalculus},
+      {"hermite", benchHermite},
+      {"smoothing", benchSmoothing},
+      {"newton", benchNewton},
+      {"piecewise", benchPiecewise},
+      {"barycentric", benchBarycentric},
+      {"approx", benchApprox},
+      {"qr", benchApproxQr},
+      {"sweep", benchSweep},
+      {"online", benchOnline},
+      {"rolling", benchRolling},
+      {"solver", benchSolver},
+      {"smallslae", benchSmallSlae},
+      {"pool", benchPool},
+      {"lu", benchBlockedLu},
+  };
+  for (auto& it : sections) {
+    if (argc < 2 || !std::strcmp(argv[1], it.first)) {
+      it.second();
+      std::cout << std::endl;
+    }
+  }
+  return 0;
+}
@@ -25,37 +25,168 @@ class Controller {
     }
   }
 
-  std::vector<DataPoint>& GetData() { return model_->getData(); }
+  TimeSeries& GetData() { return model_->getData(); }
   void ShowData() { model_->showData(); }
   void Clear() { model_->clearData(); }
 
+  void SetInterpolationForm(InterpolationForm form) {
+    model_->setInterpolationForm(form);
+  }
   void initNewtonPolynomial(const std::vector<Point>& points) {
     model_->initNewtonPolynomial(points);
   }
-  void initNewtonPolynomial(std::vector<DataPoint>& data_points) {
+  void initNewtonPolynomial(const TimeSeries& data_points) {
     model_->initNewtonPolynomial(data_points);
   }
+  void AddNewtonNode(const Point& point) { model_->addNewtonNode(point); }
   std::vector<double>& GetNewtonCoeff() { return model_->getNewtonCoeff(); }
   double GetNewtonValue(double t) { return model_->getNewtonValue(t); }
+  void GetNewtonValues(const std::vector<double>& t,
+                       std::vector<double>& out) {
+    model_->getNewtonValues(t, out);
+  }
+  double GetNewtonDerivative(double t, int order = 1) {
+    return model_->getNewtonDerivative(t, order);
+  }
+  void GetNewtonDerivatives(const std::vector<double>& t,
+                            std::vector<double>& out, int order = 1) {
+    model_->getNewtonDerivatives(t, out, order);
+  }
+  double GetNewtonIntegral(double from, double to) {
+    return model_->getNewtonIntegral(from, to);
+  }
+  void GetNewtonIntegrals(const std::vector<double>& from,
+                          const std::vector<double>& to,
+                          std::vector<double>& out) {
+    model_->getNewtonIntegrals(from, to, out);
+  }
+
+  void initPiecewiseNewton(const TimeSeries& data_points, size_t degree) {
+    model_->initPiecewiseNewton(data_points, degree);
+  }
+  void SetPiecewiseNewtonDegree(size_t degree) {
+    model_->setPiecewiseNewtonDegree(degree);
+  }
+  double GetPiecewiseNewtonValue(double t) {
+    return model_->getPiecewiseNewtonValue(t);
+  }
+  void GetPiecewiseNewtonValues(const std::vector<double>& t,
+                                std::vector<double>& out) {
+    model_->getPiecewiseNewtonValues(t, out);
+  }
 
   void initCubicSpline(const std::vector<Point>& points) {
     model_->initCubicSpline(points);
   }
-  void initCubicSpline(std::vector<DataPoint>& data_points) {
+  void initCubicSpline(const TimeSeries& data_points) {
     model_->initCubicSpline(data_points);
   }
-  Matrix& GetSplineCoeff() { return model_->getSplineCoeff(); }
+  void AppendSplinePoints(const std::vector<Point>& points) {
+    model_->appendSplinePoints(points);
+  }
+  void SetSplineLayout(CoeffLayout layout) { model_->setSplineLayout(layout); }
+  SplineCoeffView GetSplineCoeff() { return model_->getSplineCoeff(); }
   double GetSplineValue(double t) { return model_->getSplineValue(t); }
+  void GetSplineValues(const std::vector<double>& t,
+                       std::vector<double>& out) {
+    model_->getSplineValues(t, out);
+  }
+  double GetSplineDerivative(double t, int order = 1) {
+    return model_->getSplineDerivative(t, order);
+  }
+  void GetSplineDerivatives(const std::vector<double>& t,
+                            std::vector<double>& out, int order = 1) {
+    model_->getSplineDerivatives(t, out, order);
+  }
+  double GetSplineIntegral(double from, double to) {
+    return model_->getSplineIntegral(from, to);
+  }
+  void GetSplineIntegrals(const std::vector<double>& from,
+                          const std::vector<double>& to,
+                          std::vector<double>& out) {
+    model_->getSplineIntegrals(from, to, out);
+  }
+
+  void SetSmoothing(double lambda) { model_->setSmoothing(lambda); }
+  void SetAutoSmoothing(bool on) { model_->setAutoSmoothing(on); }
+  void initSmoothingSpline(const std::vector<Point>& points) {
+    model_->initSmoothingSpline(points);
+  }
+  void initSmoothingSpline(const TimeSeries& data_points) {
+    model_->initSmoothingSpline(data_points);
+  }
+  double GetSmoothing() { return model_->getSmoothing(); }
+  SplineCoeffView GetSmoothingCoeff() { return model_->getSmoothingCoeff(); }
+  double GetSmoothingValue(double t) { return model_->getSmoothingValue(t); }
+  void GetSmoothingValues(const std::vector<double>& t,
+                          std::vector<double>& out) {
+    model_->getSmoothingValues(t, out);
+  }
 
+  void initHermiteSpline(const std::vector<Point>& points) {
+    model_->initHermiteSpline(points);
+  }
+  void initHermiteSpline(const TimeSeries& data_points) {
+    model_->initHermiteSpline(data_points);
+  }
+  void AppendHermitePoints(const std::vector<Point>& points) {
+    model_->appendHermitePoints(points);
+  }
+  SplineCoeffView GetHermiteCoeff() { return model_->getHermiteCoeff(); }
+  double GetHermiteValue(double t) { return model_->getHermiteValue(t); }
+  void GetHermiteValues(const std::vector<double>& t,
+                        std::vector<double>& out) {
+    model_->getHermiteValues(t, out);
+  }
+
+  void SetApproxMethod(ApproxMethod method) { model_->setApproxMethod(method); }
   void initApproximation(const std::vector<Point>& points, const int degree) {
     model_->initApproximation(points, degree);
   }
-  void initApproximation(std::vector<DataPoint>& data_points,
-                         const int degree) {
+  void initApproximation(const TimeSeries& data_points, const int degree) {
     model_->initApproximation(data_points, degree);
   }
+  void initApproximation(const std::vector<Point>& points,
+                         const std::vector<double>& weights, const int degree) {
+    model_->initApproximation(points, weights, degree);
+  }
+  void initApproximation(const TimeSeries& data_points,
+                         const std::vector<double>& weights, const int degree) {
+    model_->initApproximation(data_points, weights, degree);
+  }
+  // Seconds for the loaded quotes
+  void SetApproxHalfLife(double half_life) {
+    model_->setApproxHalfLife(half_life);
+  }
+  void SetApproxAutoDegree(bool on) { model_->setApproxAutoDegree(on); }
+  int GetApproxDegree() { return model_->getApproxDegree(); }
+  const std::vector<double>& GetApproxScores() {
+    return model_->getApproxScores();
+  }
+  bool SelectApproxDegree(const int degree) {
+    return model_->selectApproxDegree(degree);
+  }
   std::vector<double>& GetApproxCoeff() { return model_->getApproxCoeff(); }
   double GetApproxValue(double t) { return model_->getApproxValue(t); }
+  void GetApproxValues(const std::vector<double>& t,
+                       std::vector<double>& out) {
+    model_->getApproxValues(t, out);
+  }
+  double GetApproxDerivative(double t, int order = 1) {
+    return model_->getApproxDerivative(t, order);
+  }
+  void GetApproxDerivatives(const std::vector<double>& t,
+                            std::vector<double>& out, int order = 1) {
+    model_->getApproxDerivatives(t, out, order);
+  }
+  double GetApproxIntegral(double from, double to) {
+    return model_->getApproxIntegral(from, to);
+  }
+  void GetApproxIntegrals(const std::vector<double>& from,
+                          const std::vector<double>& to,
+                          std::vector<double>& out) {
+    model_->getApproxIntegrals(from, to, out);
+  }
 
  private:
   s21::Model* model_;
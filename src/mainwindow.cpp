@@ -51,10 +51,13 @@ void MainWindow::on_pushButtonInfo_clicked() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
   ui->textInfo->append("Value, Data (" +
                        QString::number(ctrl.GetData().size()) + " points):\n");
+  const s21::TimeSeries& graph = ctrl.GetData();
   char date[11];
-  for (auto& it : ctrl.GetData()) {
-    strftime(date, 11, "%Y-%m-%d", &it.first);
-    ui->textInfo->append(QString::number(it.second) + "\t" +
+  std::tm local{};
+  for (size_t i = 0; i < graph.size(); ++i) {
+    std::time_t time = static_cast<std::time_t>(graph.time[i]);
+    strftime(date, 11, "%Y-%m-%d", localtime_r(&time, &local));
+    ui->textInfo->append(QString::number(graph.value[i]) + "\t" +
                          QString::fromUtf8(date, 11));
   }
 }
@@ -84,10 +87,10 @@ void MainWindow::on_pushButtonOpen_clicked() {
       ui->lineEditResultSpline->setText("");
       ui->lineEditResultApprox->setText("");
       ui->spinBoxDaysExt->setValue(0);
-      ui->dateTimeEdit->setDateTime(QDateTime::fromSecsSinceEpoch(
-          std::mktime(&(ctrl.GetData().front().first))));
-      ui->dateTimeEdit_a->setDateTime(QDateTime::fromSecsSinceEpoch(
-          std::mktime(&(ctrl.GetData().front().first))));
+      ui->dateTimeEdit->setDateTime(
+          QDateTime::fromSecsSinceEpoch(ctrl.GetData().time.front()));
+      ui->dateTimeEdit_a->setDateTime(
+          QDateTime::fromSecsSinceEpoch(ctrl.GetData().time.front()));
     }
   }
 }
@@ -124,13 +127,13 @@ void MainWindow::on_pushButtonDrawPlot_clicked() {
 
 void MainWindow::on_pushButtonCalculate_clicked() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
     double value =
         static_cast<double>(ui->dateTimeEdit->dateTime().toSecsSinceEpoch());
-    if ((std::mktime(&(graph.front().first)) - s21::kEps) > value ||
-        (std::mktime(&(graph.back().first)) + s21::kEps) < value) {
+    if ((graph.time.front() - s21::kEps) > value ||
+        (graph.time.back() + s21::kEps) < value) {
       ui->lineEditResultNewton->setText("n/a");
       ui->lineEditResultSpline->setText("n/a");
       ui->textInfo->append("Cannot be calculated, date out of range");
@@ -162,7 +165,7 @@ void MainWindow::on_pushButtonCalculate_clicked() {
 
 void MainWindow::on_pushButtonDrawPlot_a_clicked() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
     size_t intervals = static_cast<size_t>(ui->spinBoxNumPoints_a->value()) - 1;
@@ -173,22 +176,23 @@ void MainWindow::on_pushButtonDrawPlot_a_clicked() {
         ui->approxPlot->clearGraphs();
         drawGraph(ui->approxPlot);
       }
-      double begin = std::mktime(&(graph.front().first));
-      double end =
-          std::mktime(&(graph.back().first)) + days_ext_ * s21::kSecInDay;
+      double begin = graph.time.front();
+      double end = graph.time.back() + days_ext_ * s21::kSecInDay;
       double step = (end - begin) / intervals;
 
-      QVector<double> values, dates;
-      ctrl.initApproximation(graph, degree);
+      std::vector<double> dates, values;
       for (double current = begin; current < end + s21::kEps; current += step) {
         dates.push_back(current);
-        values.push_back(ctrl.GetApproxValue(current));
       }
+      ctrl.initApproximation(graph, degree);
+      ctrl.GetApproxValues(dates, values);
 
       int count = ui->approxPlot->graphCount();
       if (count <= s21::kMaxCountGraph) {
         ui->approxPlot->addGraph();
-        ui->approxPlot->graph(count)->setData(dates, values);
+        ui->approxPlot->graph(count)->setData(
+            QVector<double>(dates.begin(), dates.end()),
+            QVector<double>(values.begin(), values.end()));
         ui->approxPlot->graph()->setPen(kGraphColors[count]);
         ui->approxPlot->graph()->setName(
             "Approx, " + QString::number(intervals + 1) + " points, " +
@@ -209,12 +213,12 @@ void MainWindow::on_pushButtonDrawPlot_a_clicked() {
 
 void MainWindow::on_pushButtonCalculate_a_clicked() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
     double value =
         static_cast<double>(ui->dateTimeEdit_a->dateTime().toSecsSinceEpoch());
-    if ((std::mktime(&(graph.front().first)) - s21::kEps) > value) {
+    if ((graph.time.front() - s21::kEps) > value) {
       ui->lineEditResultApprox->setText("n/a");
       ui->textInfo->append("Cannot be calculated, date out of range");
       return;
@@ -237,14 +241,11 @@ void MainWindow::on_pushButtonCalculate_a_clicked() {
 
 void MainWindow::drawGraph(QCustomPlot* plot) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
-    QVector<double> values, dates;
-    for (auto& it : graph) {
-      values.push_back(it.second);
-      dates.push_back(std::mktime(&(it.first)));
-    }
+    QVector<double> values(graph.value.begin(), graph.value.end());
+    QVector<double> dates(graph.time.begin(), graph.time.end());
 
     plot->addGraph();
     plot->graph(0)->setData(dates, values);
@@ -278,42 +279,29 @@ void MainWindow::setScale(QCustomPlot* plot, const QVector<double>& dates,
 
 void MainWindow::drawNewton() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
     size_t intervals = static_cast<size_t>(ui->spinBoxNumPoints->value()) - 1;
     size_t degree = static_cast<size_t>(ui->spinBoxDegreePoly->value());
     if (graph.size() > degree) {
-      double begin = std::mktime(&(graph.front().first));
-      double end = std::mktime(&(graph.back().first));
+      double begin = graph.time.front();
+      double end = graph.time.back();
       double step = (end - begin) / intervals;
-      double current = begin;
-
-      QVector<double> values, dates;
-      std::vector<s21::DataPoint> segment;
-      for (size_t i = 0; i < graph.size() - 1; i += degree) {
-        segment.clear();
-        for (size_t j = 0; j < (degree + 1); ++j) {
-          if ((i + degree) < graph.size()) {
-            segment.push_back(graph[i + j]);
-          } else {
-            for (size_t k = graph.size() - degree - 1; k < graph.size(); ++k) {
-              segment.push_back(graph[k]);
-            }
-            break;
-          }
-        }
-        ctrl.initNewtonPolynomial(segment);
-        for (; current < std::mktime(&(segment.back().first)) + s21::kEps;) {
-          dates.push_back(current);
-          values.push_back(ctrl.GetNewtonValue(current));
-          current += step;
-        }
+
+      std::vector<double> dates, values;
+      for (double current = begin; current < end + s21::kEps; current += step) {
+        dates.push_back(current);
       }
+      ctrl.SetPiecewiseNewtonDegree(degree);
+      ctrl.GetPiecewiseNewtonValues(dates, values);
+
       int count = ui->interPlot->graphCount();
       if (count <= s21::kMaxCountGraph) {
         ui->interPlot->addGraph();
-        ui->interPlot->graph(count)->setData(dates, values);
+        ui->interPlot->graph(count)->setData(
+            QVector<double>(dates.begin(), dates.end()),
+            QVector<double>(values.begin(), values.end()));
         ui->interPlot->graph()->setPen(kGraphColors[count]);
         ui->interPlot->graph()->setName(
             "Newton, " + QString::number(intervals + 1) + " points, " +
@@ -334,26 +322,28 @@ void MainWindow::drawNewton() {
 
 void MainWindow::drawSpline() {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   if (!graph.empty()) {
     size_t intervals = static_cast<size_t>(ui->spinBoxNumPoints->value()) - 1;
     if (graph.size() > 2) {
-      double begin = std::mktime(&(graph.front().first));
-      double end = std::mktime(&(graph.back().first));
+      double begin = graph.time.front();
+      double end = graph.time.back();
       double step = (end - begin) / intervals;
 
-      QVector<double> values, dates;
-      ctrl.initCubicSpline(graph);
+      std::vector<double> dates, values;
       for (double current = begin; current < end + s21::kEps; current += step) {
         dates.push_back(current);
-        values.push_back(ctrl.GetSplineValue(current));
       }
+      ctrl.initCubicSpline(graph);
+      ctrl.GetSplineValues(dates, values);
 
       int count = ui->interPlot->graphCount();
       if (count <= s21::kMaxCountGraph) {
         ui->interPlot->addGraph();
-        ui->interPlot->graph(count)->setData(dates, values);
+        ui->interPlot->graph(count)->setData(
+            QVector<double>(dates.begin(), dates.end()),
+            QVector<double>(values.begin(), values.end()));
         ui->interPlot->graph()->setPen(kGraphColors[count]);
         ui->interPlot->graph()->setName(
             "Cubic Spline, " + QString::number(intervals + 1) + " points");
@@ -373,31 +363,14 @@ void MainWindow::drawSpline() {
 
 double MainWindow::calculateNewton(size_t degree, double value) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
-
-  std::vector<s21::DataPoint> segment;
-  for (size_t i = 0; i < graph.size() - 1; i += degree) {
-    if ((i + degree) < graph.size()) {
-      if ((std::mktime(&(graph[i].first)) - s21::kEps) < value &&
-          (std::mktime(&(graph[i + degree].first)) + s21::kEps) > value) {
-        for (size_t j = 0; j < (degree + 1); ++j) {
-          segment.push_back(graph[i + j]);
-        }
-        break;
-      }
-    } else {
-      for (size_t k = graph.size() - degree - 1; k < graph.size(); ++k) {
-        segment.push_back(graph[k]);
-      }
-    }
-  }
-  ctrl.initNewtonPolynomial(segment);
-  return ctrl.GetNewtonValue(value);
+
+  ctrl.SetPiecewiseNewtonDegree(degree);
+  return ctrl.GetPiecewiseNewtonValue(value);
 }
 
 double MainWindow::calculateSpline(double value) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   ctrl.initCubicSpline(graph);
   return ctrl.GetSplineValue(value);
@@ -405,7 +378,7 @@ double MainWindow::calculateSpline(double value) {
 
 double MainWindow::calculateApprox(int degree, double value) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
-  std::vector<s21::DataPoint> graph = ctrl.GetData();
+  const s21::TimeSeries& graph = ctrl.GetData();
 
   ctrl.initApproximation(graph, degree);
   return ctrl.GetApproxValue(value);
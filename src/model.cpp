@@ -4,7 +4,16 @@
 
 namespace s21 {
 
-void Model::loadFromFile(const std::string& fileName) {
+void Model::loadFromFile(const std::string& fileName, LoadMode mode) {
+  piecewise_on_data_ = false;
+  if (mode == LoadMode::kMapped) {
+    loader_.loadFromFile(fileName, data_points_);
+  } else {
+    loadFromStream(fileName);
+  }
+}
+
+void Model::loadFromStream(const std::string& fileName) {
   std::ifstream fp(fileName);
   if (!fp.is_open()) {
     throw std::invalid_argument("Error: can't open the " + fileName);
@@ -20,7 +29,7 @@ void Model::loadFromFile(const std::string& fileName) {
     while (!fp.eof() && std::getline(fp, line, ',')) {
       strptime(line.data(), "%Y-%m-%d", &date);
       std::getline(fp, line);
-      data_points_.push_back({date, std::stod(line)});
+      data_points_.push_back(std::mktime(&date), std::stod(line));
     }
   } catch (const std::exception& e) {
     fp.close();
@@ -28,53 +37,299 @@ void Model::loadFromFile(const std::string& fileName) {
   }
 }
 
-std::vector<DataPoint>& Model::getData() { return data_points_; }
+TimeSeries& Model::getData() { return data_points_; }
 
 void Model::showData() {
   std::cout << "Value, Data (" << data_points_.size() << " points): \n";
-  for (auto it : data_points_) {
-    std::cout << it.second << "\t" << std::asctime(&it.first);
+  std::tm date{};
+  for (size_t i = 0; i < data_points_.size(); ++i) {
+    std::time_t time = static_cast<std::time_t>(data_points_.time[i]);
+    std::cout << data_points_.value[i] << "\t"
+              << std::asctime(localtime_r(&time, &date));
   }
 }
 
-void Model::clearData() { data_points_.clear(); }
+void Model::clearData() {
+  data_points_.clear();
+  piecewise_on_data_ = false;
+}
+
+void Model::setInterpolationForm(InterpolationForm form) { form_ = form; }
 
 void Model::initNewtonPolynomial(const std::vector<Point>& points) {
-  newton_.initNewtonPolynomial(points);
+  if (form_ == InterpolationForm::kBarycentric) {
+    barycentric_.initBarycentricPolynomial(points);
+  } else {
+    newton_.initNewtonPolynomial(points);
+  }
+}
+
+void Model::initNewtonPolynomial(const TimeSeries& data_points) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    barycentric_.initBarycentricPolynomial(data_points);
+  } else {
+    newton_.initNewtonPolynomial(data_points);
+  }
+}
+
+void Model::addNewtonNode(const Point& point) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    barycentric_.addNode(point);
+  } else {
+    newton_.addNode(point);
+  }
+}
+
+std::vector<double>& Model::getNewtonCoeff() {
+  if (form_ == InterpolationForm::kBarycentric) {
+    return barycentric_.getCoeff();
+  }
+  return newton_.getCoeff();
 }
 
-void Model::initNewtonPolynomial(std::vector<DataPoint>& data_points) {
-  newton_.initNewtonPolynomial(data_points);
+double Model::getNewtonValue(double t) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    return barycentric_.getValue(t);
+  }
+  return newton_.getValue(t);
 }
 
-std::vector<double>& Model::getNewtonCoeff() { return newton_.getCoeff(); }
+void Model::getNewtonValues(const std::vector<double>& t,
+                            std::vector<double>& out) {
+  out.resize(t.size());
+  if (form_ == InterpolationForm::kBarycentric) {
+    barycentric_.evaluate(t.data(), out.data(), t.size());
+  } else {
+    newton_.evaluate(t.data(), out.data(), t.size());
+  }
+}
 
-double Model::getNewtonValue(double t) { return newton_.getValue(t); }
+double Model::getNewtonDerivative(double t, int order) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    throw std::domain_error("Error: derivatives need the Newton form");
+  }
+  return newton_.getDerivative(t, order);
+}
+
+void Model::getNewtonDerivatives(const std::vector<double>& t,
+                                 std::vector<double>& out, int order) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    throw std::domain_error("Error: derivatives need the Newton form");
+  }
+  out.resize(t.size());
+  newton_.evaluateDerivative(t.data(), out.data(), t.size(), order);
+}
+
+double Model::getNewtonIntegral(double from, double to) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    throw std::domain_error("Error: integrals need the Newton form");
+  }
+  return newton_.getIntegral(from, to);
+}
+
+void Model::getNewtonIntegrals(const std::vector<double>& from,
+                               const std::vector<double>& to,
+                               std::vector<double>& out) {
+  if (form_ == InterpolationForm::kBarycentric) {
+    throw std::domain_error("Error: integrals need the Newton form");
+  }
+  if (from.size() != to.size()) {
+    throw std::invalid_argument("Error: bounds differ in count");
+  }
+  out.resize(from.size());
+  newton_.integrate(from.data(), to.data(), out.data(), from.size());
+}
+
+void Model::initPiecewiseNewton(const TimeSeries& data_points,
+                                size_t degree) {
+  piecewise_on_data_ = false;
+  piecewise_.init(data_points, degree, 0);
+}
+
+void Model::setPiecewiseNewtonDegree(size_t degree) {
+  if (piecewise_on_data_ && piecewise_.getDegree() == degree) return;
+  initPiecewiseNewton(data_points_, degree);
+  piecewise_on_data_ = true;
+}
+
+double Model::getPiecewiseNewtonValue(double t) {
+  return piecewise_.getValue(t);
+}
+
+void Model::getPiecewiseNewtonValues(const std::vector<double>& t,
+                                     std::vector<double>& out) {
+  out.resize(t.size());
+  piecewise_.evaluate(t.data(), out.data(), t.size());
+}
 
 void Model::initCubicSpline(const std::vector<Point>& points) {
   spline_.initCubicSpline(points);
 }
 
-void Model::initCubicSpline(std::vector<DataPoint>& data_points) {
+void Model::initCubicSpline(const TimeSeries& data_points) {
   spline_.initCubicSpline(data_points);
 }
 
-Matrix& Model::getSplineCoeff() { return spline_.getCoeff(); }
+void Model::appendSplinePoints(const std::vector<Point>& points) {
+  spline_.appendPoints(points);
+}
+
+void Model::setSplineLayout(CoeffLayout layout) { spline_.setLayout(layout); }
+
+SplineCoeffView Model::getSplineCoeff() { return spline_.getCoeff(); }
 
 double Model::getSplineValue(double t) { return spline_.getValue(t); }
 
+void Model::getSplineValues(const std::vector<double>& t,
+                            std::vector<double>& out) {
+  out.resize(t.size());
+  spline_.evaluate(t.data(), out.data(), t.size());
+}
+
+double Model::getSplineDerivative(double t, int order) {
+  return spline_.getDerivative(t, order);
+}
+
+void Model::getSplineDerivatives(const std::vector<double>& t,
+                                 std::vector<double>& out, int order) {
+  out.resize(t.size());
+  spline_.evaluateDerivative(t.data(), out.data(), t.size(), order);
+}
+
+double Model::getSplineIntegral(double from, double to) {
+  return spline_.getIntegral(from, to);
+}
+
+void Model::getSplineIntegrals(const std::vector<double>& from,
+                               const std::vector<double>& to,
+                               std::vector<double>& out) {
+  if (from.size() != to.size()) {
+    throw std::invalid_argument("Error: bounds differ in count");
+  }
+  out.resize(from.size());
+  spline_.integrate(from.data(), to.data(), out.data(), from.size());
+}
+
+void Model::setSmoothing(double lambda) { smoothing_.setSmoothing(lambda); }
+
+void Model::setAutoSmoothing(bool on) { smoothing_.setAutoSmoothing(on); }
+
+void Model::initSmoothingSpline(const std::vector<Point>& points) {
+  smoothing_.initSmoothingSpline(points);
+}
+
+void Model::initSmoothingSpline(const TimeSeries& data_points) {
+  smoothing_.initSmoothingSpline(data_points);
+}
+
+double Model::getSmoothing() const { return smoothing_.getSmoothing(); }
+
+SplineCoeffView Model::getSmoothingCoeff() { return smoothing_.getCoeff(); }
+
+double Model::getSmoothingValue(double t) { return smoothing_.getValue(t); }
+
+void Model::getSmoothingValues(const std::vector<double>& t,
+                               std::vector<double>& out) {
+  out.resize(t.size());
+  smoothing_.evaluate(t.data(), out.data(), t.size());
+}
+
+void Model::initHermiteSpline(const std::vector<Point>& points) {
+  hermite_.initHermiteSpline(points);
+}
+
+void Model::initHermiteSpline(const TimeSeries& data_points) {
+  hermite_.initHermiteSpline(data_points);
+}
+
+void Model::appendHermitePoints(const std::vector<Point>& points) {
+  hermite_.appendPoints(points);
+}
+
+SplineCoeffView Model::getHermiteCoeff() { return hermite_.getCoeff(); }
+
+double Model::getHermiteValue(double t) { return hermite_.getValue(t); }
+
+void Model::getHermiteValues(const std::vector<double>& t,
+                             std::vector<double>& out) {
+  out.resize(t.size());
+  hermite_.evaluate(t.data(), out.data(), t.size());
+}
+
+void Model::setApproxMethod(ApproxMethod method) {
+  approx_.setMethod(method);
+}
+
 void Model::initApproximation(const std::vector<Point>& points,
                               const int degree) {
   approx_.initApproximation(points, degree);
 }
 
-void Model::initApproximation(std::vector<DataPoint>& data_points,
+void Model::initApproximation(const TimeSeries& data_points,
                               const int degree) {
   approx_.initApproximation(data_points, degree);
 }
 
+void Model::initApproximation(const std::vector<Point>& points,
+                              const std::vector<double>& weights,
+                              const int degree) {
+  approx_.initApproximation(points, weights, degree);
+}
+
+void Model::initApproximation(const TimeSeries& data_points,
+                              const std::vector<double>& weights,
+                              const int degree) {
+  approx_.initApproximation(data_points, weights, degree);
+}
+
+void Model::setApproxHalfLife(double half_life) {
+  approx_.setHalfLife(half_life);
+}
+
+void Model::setApproxAutoDegree(bool on) { approx_.setAutoDegree(on); }
+
+int Model::getApproxDegree() const { return approx_.getDegree(); }
+
+const std::vector<double>& Model::getApproxScores() const {
+  return approx_.getScores();
+}
+
+bool Model::selectApproxDegree(const int degree) {
+  return approx_.selectDegree(degree);
+}
+
 std::vector<double>& Model::getApproxCoeff() { return approx_.getCoeff(); }
 
 double Model::getApproxValue(double t) { return approx_.getValue(t); }
 
+void Model::getApproxValues(const std::vector<double>& t,
+                            std::vector<double>& out) {
+  out.resize(t.size());
+  approx_.evaluate(t.data(), out.data(), t.size());
+}
+
+double Model::getApproxDerivative(double t, int order) {
+  return approx_.getDerivative(t, order);
+}
+
+void Model::getApproxDerivatives(const std::vector<double>& t,
+                                 std::vector<double>& out, int order) {
+  out.resize(t.size());
+  approx_.evaluateDerivative(t.data(), out.data(), t.size(), order);
+}
+
+double Model::getApproxIntegral(double from, double to) {
+  return approx_.getIntegral(from, to);
+}
+
+void Model::getApproxIntegrals(const std::vector<double>& from,
+                               const std::vector<double>& to,
+                               std::vector<double>& out) {
+  if (from.size() != to.size()) {
+    throw std::invalid_argument("Error: bounds differ in count");
+  }
+  out.resize(from.size());
+  approx_.integrate(from.data(), to.data(), out.data(), from.size());
+}
+
 }  //   namespace s21
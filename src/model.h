@@ -5,7 +5,15 @@
 #include <vector>
 
 #include "Approximation/approximation.h"
+#include "Approximation/approximation_accumulator.h"
+#include "Approximation/gauss.h"
+#include "Approximation/rolling_regression.h"
+#include "BarycentricInterpolation/barycentric_interpolation.h"
+#include "CsvLoader/csv_loader.h"
+#include "HermiteInterpolation/hermite_interpolation.h"
 #include "NewtonInterpolation/newton_interpolation.h"
+#include "NewtonInterpolation/piecewise_newton.h"
+#include "SplineInterpolation/smoothing_spline.h"
 #include "SplineInterpolation/spline_interpolation.h"
 #include "types.h"
 
@@ -20,30 +28,114 @@ class Model {
   void operator=(const Model &) = delete;
   void operator=(Model &&) = delete;
 
-  auto loadFromFile(const std::string &filename) -> void;
-  auto getData() -> std::vector<DataPoint> &;
+  auto loadFromFile(const std::string &filename,
+                    LoadMode mode = LoadMode::kMapped) -> void;
+  auto getData() -> TimeSeries &;
   auto showData() -> void;
   auto clearData() -> void;
 
+  // Form of the single interpolation polynomial behind the *Newton* calls;
+  // for kBarycentric getNewtonCoeff() returns the barycentric weights
+  auto setInterpolationForm(InterpolationForm form) -> void;
+  auto getInterpolationForm() const -> InterpolationForm { return form_; }
   auto initNewtonPolynomial(const std::vector<Point> &) -> void;
-  auto initNewtonPolynomial(std::vector<DataPoint> &) -> void;
+  auto initNewtonPolynomial(const TimeSeries &) -> void;
+  auto addNewtonNode(const Point &) -> void;
   auto getNewtonCoeff() -> std::vector<double> &;
   auto getNewtonValue(double t) -> double;
+  auto getNewtonValues(const std::vector<double> &t, std::vector<double> &out)
+      -> void;
+  // Newton form only
+  auto getNewtonDerivative(double t, int order = 1) -> double;
+  auto getNewtonDerivatives(const std::vector<double> &t,
+                            std::vector<double> &out, int order = 1) -> void;
+  auto getNewtonIntegral(double from, double to) -> double;
+  auto getNewtonIntegrals(const std::vector<double> &from,
+                          const std::vector<double> &to,
+                          std::vector<double> &out) -> void;
+
+  auto initPiecewiseNewton(const TimeSeries &, size_t degree) -> void;
+  // Same over the loaded data, rebuilt only when it or the degree changed,
+  // so repeated queries cost O(degree)
+  auto setPiecewiseNewtonDegree(size_t degree) -> void;
+  auto getPiecewiseNewtonValue(double t) -> double;
+  auto getPiecewiseNewtonValues(const std::vector<double> &t,
+                                std::vector<double> &out) -> void;
 
   auto initCubicSpline(const std::vector<Point> &) -> void;
-  auto initCubicSpline(std::vector<DataPoint> &) -> void;
-  auto getSplineCoeff() -> Matrix &;
+  auto initCubicSpline(const TimeSeries &) -> void;
+  auto appendSplinePoints(const std::vector<Point> &) -> void;
+  auto setSplineLayout(CoeffLayout layout) -> void;
+  auto getSplineCoeff() -> SplineCoeffView;
   auto getSplineValue(double t) -> double;
+  auto getSplineValues(const std::vector<double> &t, std::vector<double> &out)
+      -> void;
+  auto getSplineDerivative(double t, int order = 1) -> double;
+  auto getSplineDerivatives(const std::vector<double> &t,
+                            std::vector<double> &out, int order = 1) -> void;
+  auto getSplineIntegral(double from, double to) -> double;
+  auto getSplineIntegrals(const std::vector<double> &from,
+                          const std::vector<double> &to,
+                          std::vector<double> &out) -> void;
+
+  // lambda >= 0, in mean knot spacings; auto selects it by GCV
+  auto setSmoothing(double lambda) -> void;
+  auto setAutoSmoothing(bool on) -> void;
+  auto initSmoothingSpline(const std::vector<Point> &) -> void;
+  auto initSmoothingSpline(const TimeSeries &) -> void;
+  auto getSmoothing() const -> double;
+  auto getSmoothingCoeff() -> SplineCoeffView;
+  auto getSmoothingValue(double t) -> double;
+  auto getSmoothingValues(const std::vector<double> &t,
+                          std::vector<double> &out) -> void;
 
+  auto initHermiteSpline(const std::vector<Point> &) -> void;
+  auto initHermiteSpline(const TimeSeries &) -> void;
+  auto appendHermitePoints(const std::vector<Point> &) -> void;
+  auto getHermiteCoeff() -> SplineCoeffView;
+  auto getHermiteValue(double t) -> double;
+  auto getHermiteValues(const std::vector<double> &t, std::vector<double> &out)
+      -> void;
+
+  auto setApproxMethod(ApproxMethod method) -> void;
   auto initApproximation(const std::vector<Point> &, const int) -> void;
-  auto initApproximation(std::vector<DataPoint> &, const int) -> void;
+  auto initApproximation(const TimeSeries &, const int) -> void;
+  auto initApproximation(const std::vector<Point> &,
+                         const std::vector<double> &, const int) -> void;
+  auto initApproximation(const TimeSeries &, const std::vector<double> &,
+                         const int) -> void;
+  auto setApproxHalfLife(double half_life) -> void;
+  // Degree passed to initApproximation() becomes the highest one tried
+  auto setApproxAutoDegree(bool on) -> void;
+  auto getApproxDegree() const -> int;
+  auto getApproxScores() const -> const std::vector<double> &;
+  // ApproxMethod::kOrthogonal: any degree up to the fitted one, no refit
+  auto selectApproxDegree(const int) -> bool;
   auto getApproxCoeff() -> std::vector<double> &;
   auto getApproxValue(double t) -> double;
+  auto getApproxValues(const std::vector<double> &t, std::vector<double> &out)
+      -> void;
+  auto getApproxDerivative(double t, int order = 1) -> double;
+  auto getApproxDerivatives(const std::vector<double> &t,
+                            std::vector<double> &out, int order = 1) -> void;
+  auto getApproxIntegral(double from, double to) -> double;
+  auto getApproxIntegrals(const std::vector<double> &from,
+                          const std::vector<double> &to,
+                          std::vector<double> &out) -> void;
 
  private:
-  std::vector<DataPoint> data_points_;
+  auto loadFromStream(const std::string &filename) -> void;
+
+  TimeSeries data_points_;
+  CsvLoader loader_;
+  InterpolationForm form_{InterpolationForm::kNewton};
   NewtonInterpolation newton_;
+  BarycentricInterpolation barycentric_;
+  PiecewiseNewton piecewise_;
+  bool piecewise_on_data_{false};  // piecewise_ is built from data_points_
   SplineInterpolation spline_;
+  SmoothingSpline smoothing_;
+  HermiteInterpolation hermite_;
   Approximation approx_;
 };
 
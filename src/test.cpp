@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
 #include "controller.h"
 
 const std::string kDataSet = "./datasets/";
@@ -19,6 +26,118 @@ TEST(model, LoadFromFile_ShowData) {
   ASSERT_EQ(4, 4);
 }
 
+TEST(model, LoadFromFile_Mapped) {
+  const char* files[] = {"AAPL.csv", "F_10.csv", "two_points.csv", "x2.csv"};
+  for (auto name : files) {
+    s21::Model stream, mapped;
+    stream.loadFromFile(kDataSet + name, s21::LoadMode::kStream);
+    mapped.loadFromFile(kDataSet + name, s21::LoadMode::kMapped);
+    ASSERT_EQ(stream.getData().size(), mapped.getData().size());
+    ASSERT_EQ(stream.getData().time, mapped.getData().time);
+    ASSERT_EQ(stream.getData().value, mapped.getData().value);
+  }
+}
+
+TEST(model, LoadFromFile_OffsetChange) {
+  // Moscow was on UTC+4 from 2011 to 2014 and on UTC+3 before and after
+  const char* saved = std::getenv("TZ");
+  std::string zone = saved ? saved : "";
+  setenv("TZ", "Europe/Moscow", 1);
+  tzset();
+  const std::string name = "/tmp/s21_offset_change.csv";
+  {
+    std::ofstream file(name);
+    file << "Date,Close\n";
+    for (int year = 2010; year <= 2015; ++year) {
+      for (int month = 1; month <= 12; month += 5) {
+        file << year << "-" << (month < 10 ? "0" : "") << month << "-04,"
+             << year + month * 0.5 << "\n";
+      }
+    }
+  }
+  s21::Model stream, mapped;
+  stream.loadFromFile(name, s21::LoadMode::kStream);
+  mapped.loadFromFile(name, s21::LoadMode::kMapped);
+  std::remove(name.c_str());
+  if (saved) {
+    setenv("TZ", zone.c_str(), 1);
+  } else {
+    unsetenv("TZ");
+  }
+  tzset();
+  ASSERT_EQ(mapped.getData().size(), 18U);
+  ASSERT_EQ(stream.getData().time, mapped.getData().time);
+  ASSERT_EQ(mapped.getData().time[0] % s21::kSecInDay,
+            s21::kSecInDay - 3 * 3600);
+  ASSERT_EQ(mapped.getData().time[9] % s21::kSecInDay,
+            s21::kSecInDay - 4 * 3600);
+}
+
+TEST(model, LoadFromFile_DailyOffsets) {
+  // Every date against its own std::mktime(), across standard offset
+  // changes (Moscow 2011, 2014) and DST switches (New York). The file is
+  // big enough to be mapped rather than read.
+  const char* saved = std::getenv("TZ");
+  std::string zone = saved ? saved : "";
+  const std::string name = "/tmp/s21_daily_offsets.csv";
+  {
+    std::ofstream file(name);
+    file << "Date,Close\n";
+    for (std::int64_t day = 14600; day < 16800; ++day) {
+      std::time_t t = static_cast<std::time_t>(day * s21::kSecInDay);
+      char date[16];
+      std::strftime(date, sizeof(date), "%Y-%m-%d", std::gmtime(&t));
+      file << date << "," << std::setprecision(17) << -day / 7e5 << "\n";
+    }
+  }
+  for (const char* tz : {"Europe/Moscow", "America/New_York"}) {
+    setenv("TZ", tz, 1);
+    tzset();
+    s21::Model stream, mapped;
+    stream.loadFromFile(name, s21::LoadMode::kStream);
+    mapped.loadFromFile(name, s21::LoadMode::kMapped);
+    const auto& time = mapped.getData().time;
+    ASSERT_EQ(time.size(), 2200U);
+    ASSERT_EQ(stream.getData().value, mapped.getData().value);
+    for (size_t i = 0; i < time.size(); ++i) {
+      std::time_t t = static_cast<std::time_t>((14600 + i) * s21::kSecInDay);
+      std::tm date{};
+      gmtime_r(&t, &date);
+      date.tm_isdst = 0;
+      ASSERT_EQ(time[i], std::mktime(&date)) << tz << " row " << i;
+    }
+  }
+  std::remove(name.c_str());
+  if (saved) {
+    setenv("TZ", zone.c_str(), 1);
+  } else {
+    unsetenv("TZ");
+  }
+  tzset();
+}
+
+TEST(model, LoadFromFile_Errors) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  ASSERT_EQ(ctrl.LoadFromFile(kDataSet + "none.csv"),
+            "Error: can't open the " + kDataSet + "none.csv");
+  ASSERT_EQ(ctrl.LoadFromFile(kDataSet + "err.csv"), "Error: incorrect header");
+  ASSERT_TRUE(ctrl.GetData().empty());
+
+  s21::CsvLoader loader;
+  s21::TimeSeries data;
+  std::string text = "Date,Close\r\n2021-03-22,16\r\n2021-3-23, 1.5e1\n\n";
+  loader.loadFromBuffer(text.data(), text.size(), data);
+  ASSERT_EQ(data.size(), 2U);
+  ASSERT_EQ(data.time[1] - data.time[0], s21::kSecInDay);
+  ASSERT_EQ(data.value[1], 15.0);
+
+  text = "Date,Close\n2021-03-22;16\n";
+  ASSERT_THROW(loader.loadFromBuffer(text.data(), text.size(), data),
+               std::out_of_range);
+}
+
 TEST(model, GetNewtonCoeff_1) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
   ctrl.Connect(&model);
@@ -62,6 +181,147 @@ TEST(model, GetNewtonCoeff_2) {
   }
 }
 
+TEST(model, NewtonAddNode) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  std::vector<s21::Point> points{{1, 0}, {2, 6}, {3, 28}, {4, 96}, {5, 252}};
+  std::vector<double> sample_coeff{0, 6, 8, 5, 0.5};
+  ctrl.initNewtonPolynomial(
+      std::vector<s21::Point>(points.begin(), points.begin() + 1));
+  for (size_t i = 1; i < points.size(); ++i) {
+    ctrl.AddNewtonNode(points[i]);
+  }
+  ASSERT_EQ(ctrl.GetNewtonCoeff(), sample_coeff);
+  ASSERT_EQ(ctrl.GetNewtonValue(8), 1848);
+
+  ctrl.AddNewtonNode({6.5, 900});
+  ASSERT_NEAR(ctrl.GetNewtonValue(6.5), 900, 1e-9);
+  for (auto& it : points) {
+    ASSERT_NEAR(ctrl.GetNewtonValue(it.first), it.second, 1e-9);
+  }
+}
+
+TEST(model, Barycentric) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  std::vector<s21::Point> points{{1, 0}, {2, 6}, {3, 28}, {4, 96}, {5, 252}};
+  std::vector<double> t, out;
+  for (int i = 0; i <= 100; ++i) {
+    t.push_back(0.5 + 0.05 * i);
+  }
+  ctrl.SetInterpolationForm(s21::InterpolationForm::kBarycentric);
+  ctrl.initNewtonPolynomial(points);
+  // 1 / prod(x(i) - x(j)) = {1, -4, 6, -4, 1} / 24, scaled to max |w| = 1
+  std::vector<double> sample_weights{1, -4, 6, -4, 1};
+  for (size_t i = 0; i < points.size(); ++i) {
+    ASSERT_DOUBLE_EQ(ctrl.GetNewtonCoeff()[i], sample_weights[i] / 6);
+  }
+  ASSERT_NEAR(ctrl.GetNewtonValue(8), 1848, 1e-9);
+  ctrl.GetNewtonValues(t, out);
+  for (size_t i = 0; i < t.size(); ++i) {
+    double x = t[i];
+    double sample =
+        (x - 1) * (6 + (x - 2) * (8 + (x - 3) * (5 + (x - 4) * 0.5)));
+    ASSERT_NEAR(out[i], sample, 1e-9);
+    ASSERT_DOUBLE_EQ(out[i], ctrl.GetNewtonValue(x));
+  }
+  for (auto& it : points) {
+    ASSERT_EQ(ctrl.GetNewtonValue(it.first), it.second);
+  }
+
+  ctrl.initNewtonPolynomial({points[0], points[1]});
+  for (size_t i = 2; i < points.size(); ++i) {
+    ctrl.AddNewtonNode(points[i]);
+  }
+  for (size_t i = 0; i < points.size(); ++i) {
+    ASSERT_DOUBLE_EQ(ctrl.GetNewtonCoeff()[i], sample_weights[i] / 6);
+  }
+  ASSERT_THROW(ctrl.AddNewtonNode({3, 1}), std::invalid_argument);
+
+  s21::TimeSeries data;
+  for (int i = 0; i < 40; ++i) {
+    data.push_back(1600000000 + 86400 * i, 100 + i % 7);
+  }
+  ctrl.initNewtonPolynomial(data);
+  for (size_t i = 0; i < data.size(); ++i) {
+    ASSERT_TRUE(std::isfinite(ctrl.GetNewtonCoeff()[i]));
+    ASSERT_EQ(ctrl.GetNewtonValue(data.time[i]), data.value[i]);
+  }
+  ctrl.SetInterpolationForm(s21::InterpolationForm::kNewton);
+}
+
+TEST(model, PiecewiseNewton) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  s21::TimeSeries data;
+  for (int i = 0; i < 11; ++i) {
+    data.push_back(86400 * (i + (i % 3) * 0.25), 10 + (i * 7) % 5);
+  }
+  s21::PiecewiseNewton piecewise;
+  piecewise.init(data, 3);
+  ASSERT_EQ(piecewise.getSegmentCount(), 4);
+  ASSERT_EQ(piecewise.getFirstPoint(3), 7);
+
+  std::vector<double> t, out;
+  for (int i = 0; i <= 200; ++i) {
+    t.push_back(data.time.front() + i * (data.time.back() - data.time.front()) /
+                                        200.0);
+  }
+  ctrl.initPiecewiseNewton(data, 3);
+  ctrl.GetPiecewiseNewtonValues(t, out);
+  for (size_t i = 0; i < t.size(); ++i) {
+    size_t first = piecewise.getFirstPoint(piecewise.findSegment(t[i]));
+    std::vector<s21::Point> segment;
+    for (size_t k = first; k < first + 4; ++k) {
+      segment.push_back({data.time[k], data.value[k]});
+    }
+    ctrl.initNewtonPolynomial(segment);
+    ASSERT_NEAR(out[i], ctrl.GetNewtonValue(t[i]), 1e-9);
+    ASSERT_DOUBLE_EQ(out[i], ctrl.GetPiecewiseNewtonValue(t[i]));
+  }
+  ASSERT_EQ(piecewise.findSegment(data.time[3]), 0);
+  ASSERT_EQ(piecewise.findSegment(data.time[3] + 1), 1);
+
+  s21::PiecewiseNewton parallel;
+  parallel.init(data, 3, 3);
+  for (size_t k = 0; k < piecewise.getSegmentCount(); ++k) {
+    ASSERT_EQ(parallel.getCoeff(k), piecewise.getCoeff(k));
+  }
+  ASSERT_THROW(parallel.init(data, 11), std::invalid_argument);
+  ASSERT_THROW(parallel.getValue(0), std::domain_error);
+}
+
+TEST(model, PiecewiseNewton_Cached) {
+  s21::Model local;
+  s21::PiecewiseNewton expected;
+  auto check = [&local, &expected](size_t degree) {
+    local.setPiecewiseNewtonDegree(degree);
+    expected.init(local.getData(), degree);
+    const auto& time = local.getData().time;
+    for (double t = time.front(); t <= time.back(); t += 3600 * 7.5) {
+      ASSERT_DOUBLE_EQ(local.getPiecewiseNewtonValue(t), expected.getValue(t));
+    }
+  };
+  local.loadFromFile(kDataSet + "F_10.csv");
+  check(3);
+  check(3);
+  check(2);
+  // Built from other data, so the next call goes back to the loaded one
+  s21::TimeSeries other;
+  other.push_back(0, 1);
+  other.push_back(s21::kSecInDay, 5);
+  local.initPiecewiseNewton(other, 1);
+  check(2);
+  local.clearData();
+  local.loadFromFile(kDataSet + "F_20.csv");
+  check(2);
+  local.clearData();
+  ASSERT_THROW(local.setPiecewiseNewtonDegree(2), std::invalid_argument);
+}
+
 TEST(model, GetSplineCoeff_1) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
   ctrl.Connect(&model);
@@ -70,9 +330,9 @@ TEST(model, GetSplineCoeff_1) {
 
   ctrl.initCubicSpline(points);
   auto result = ctrl.GetSplineCoeff();
-  for (auto& it_h : result) {
-    for (auto& it_v : it_h) {
-      std::cout << it_v << " ";
+  for (size_t i = 0; i < result.rows(); ++i) {
+    for (size_t j = 0; j < result.cols(); ++j) {
+      std::cout << result(i, j) << " ";
     }
     std::cout << std::endl;
   }
@@ -94,9 +354,9 @@ TEST(model, GetSplineCoeff_2) {
 
   ctrl.initCubicSpline(points);
   auto result = ctrl.GetSplineCoeff();
-  for (auto& it_h : result) {
-    for (auto& it_v : it_h) {
-      std::cout << it_v << " ";
+  for (size_t i = 0; i < result.rows(); ++i) {
+    for (size_t j = 0; j < result.cols(); ++j) {
+      std::cout << result(i, j) << " ";
     }
     std::cout << std::endl;
   }
@@ -109,6 +369,426 @@ TEST(model, GetSplineCoeff_2) {
   ASSERT_NEAR(ctrl.GetSplineValue(t), 4.41089, 1e-6);
 }
 
+TEST(model, SplineCoeffLayout) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  std::vector<s21::Point> points{
+      {1, 2}, {1.5, 3}, {2.0, 2.5}, {2.5, 4}, {3, 4.5}, {4, 1}};
+  ctrl.SetSplineLayout(s21::CoeffLayout::kSegments);
+  ctrl.initCubicSpline(points);
+  s21::SplineCoeffView segments = ctrl.GetSplineCoeff();
+  std::vector<double> saved;
+  for (size_t i = 0; i < segments.rows(); ++i) {
+    for (size_t j = 0; j < segments.cols(); ++j) {
+      saved.push_back(segments(i, j));
+    }
+  }
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(segments.data()) % 32, 0U);
+  double value = ctrl.GetSplineValue(2.7);
+
+  ctrl.SetSplineLayout(s21::CoeffLayout::kComponents);
+  s21::SplineCoeffView components = ctrl.GetSplineCoeff();
+  ASSERT_EQ(components.layout(), s21::CoeffLayout::kComponents);
+  ASSERT_EQ(components.rows(), points.size());
+  for (size_t i = 0; i < components.rows(); ++i) {
+    for (size_t j = 0; j < components.cols(); ++j) {
+      ASSERT_EQ(components(i, j), saved[i * components.cols() + j]);
+    }
+  }
+  ASSERT_EQ(ctrl.GetSplineValue(2.7), value);
+  ctrl.initCubicSpline(points);
+  ASSERT_EQ(ctrl.GetSplineValue(2.7), value);
+  ctrl.SetSplineLayout(s21::CoeffLayout::kSegments);
+}
+
+TEST(model, SplineAppendPoints) {
+  std::vector<s21::Point> points;
+  for (int i = 0; i < 200; ++i) {
+    points.push_back({i * 1.5 + (i % 3) * 0.25, std::sin(i * 0.3) + i % 7});
+  }
+  for (auto layout :
+       {s21::CoeffLayout::kSegments, s21::CoeffLayout::kComponents}) {
+    s21::SplineInterpolation full, live;
+    full.setLayout(layout);
+    live.setLayout(layout);
+    full.initCubicSpline(points);
+    live.initCubicSpline(
+        std::vector<s21::Point>(points.begin(), points.begin() + 2));
+    live.appendPoints(
+        std::vector<s21::Point>(points.begin() + 2, points.end()));
+    s21::SplineCoeffView lhs = full.getCoeff(), rhs = live.getCoeff();
+    ASSERT_EQ(lhs.rows(), rhs.rows());
+    for (size_t i = 1; i < lhs.rows(); ++i) {
+      for (size_t j = 0; j < lhs.cols(); ++j) {
+        ASSERT_EQ(lhs(i, j), rhs(i, j)) << i << " " << j;
+      }
+    }
+  }
+
+  s21::SplineInterpolation full, live;
+  full.initCubicSpline(points);
+  live.setAppendTolerance(1e-9);
+  live.initCubicSpline(
+      std::vector<s21::Point>(points.begin(), points.begin() + 100));
+  live.appendPoints(std::vector<s21::Point>(points.begin() + 100, points.end()));
+  for (double t = points.front().first; t < points.back().first; t += 0.37) {
+    ASSERT_NEAR(full.getValue(t), live.getValue(t), 1e-8);
+  }
+  ASSERT_THROW(live.appendPoint(points.back()), std::invalid_argument);
+}
+
+TEST(model, SplineParallel) {
+  std::vector<s21::Point> points;
+  for (int i = 0; i < 60000; ++i) {
+    points.push_back(
+        {i * 0.5 + (i % 5) * 0.05, std::sin(i * 0.01) * 50 + i % 3});
+  }
+  s21::ThreadPool pool(3);
+  s21::SplineInterpolation serial, parallel;
+  parallel.setThreadPool(pool);
+  parallel.setParallelThreshold(1000);
+  serial.initCubicSpline(points);
+  parallel.initCubicSpline(points);
+  s21::SplineCoeffView lhs = serial.getCoeff(), rhs = parallel.getCoeff();
+  double largest = 0;
+  for (size_t i = 0; i < lhs.rows(); ++i) {
+    largest = std::max(largest, std::fabs(lhs(i, 2)));
+  }
+  for (size_t i = 0; i < lhs.rows(); ++i) {
+    ASSERT_NEAR(lhs(i, 2), rhs(i, 2), 1e-12 * largest) << i;
+    ASSERT_EQ(lhs(i, 0), rhs(i, 0));
+  }
+  for (double t = 1.3; t < points.back().first; t += 997.1) {
+    ASSERT_NEAR(serial.getValue(t), parallel.getValue(t), 1e-9);
+  }
+
+  serial.appendPoint({points.back().first + 0.4, 7});
+  parallel.appendPoint({points.back().first + 0.4, 7});
+  ASSERT_NEAR(serial.getValue(points.back().first + 0.2),
+              parallel.getValue(points.back().first + 0.2), 1e-9);
+
+  parallel.setParallelThreshold(s21::kParallelSplineKnots);
+  serial.initCubicSpline(points);
+  parallel.initCubicSpline(points);
+  lhs = serial.getCoeff();
+  rhs = parallel.getCoeff();
+  for (size_t i = 0; i < lhs.rows(); i += 101) {
+    ASSERT_EQ(lhs(i, 2), rhs(i, 2));
+  }
+}
+
+TEST(model, SmoothingSpline) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  std::mt19937 gen(7);
+  std::normal_distribution<double> noise(0, 0.2);
+  std::vector<s21::Point> points;
+  for (int i = 0; i < 400; ++i) {
+    points.push_back({1.6e9 + i * 60.0 + (i % 3) * 7.0,
+                      std::sin(i * 0.02) + noise(gen)});
+  }
+  ctrl.SetSmoothing(0);
+  ctrl.initSmoothingSpline(points);
+  for (auto& it : points) {
+    ASSERT_NEAR(ctrl.GetSmoothingValue(it.first), it.second, 1e-9);
+  }
+
+  // Far too smooth: the least squares line
+  ctrl.SetSmoothing(1e12);
+  ctrl.initSmoothingSpline(points);
+  ctrl.initApproximation(points, 1);
+  for (size_t i = 0; i < points.size(); i += 13) {
+    ASSERT_NEAR(ctrl.GetSmoothingValue(points[i].first),
+                ctrl.GetApproxValue(points[i].first), 1e-4);
+  }
+
+  ctrl.SetAutoSmoothing(true);
+  ctrl.initSmoothingSpline(points);
+  ASSERT_GT(ctrl.GetSmoothing(), 0);
+  double error = 0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    error += std::pow(ctrl.GetSmoothingValue(points[i].first) -
+                          std::sin(i * 0.02), 2);
+  }
+  ASSERT_LT(std::sqrt(error / points.size()), 0.1);
+  // C2 joins
+  s21::SplineCoeffView coeff = ctrl.GetSmoothingCoeff();
+  for (size_t i = 1; i + 1 < coeff.rows(); ++i) {
+    double h = points[i + 1].first - points[i].first;
+    ASSERT_NEAR(coeff(i + 1, 1) - 2 * coeff(i + 1, 2) * h +
+                    3 * coeff(i + 1, 3) * h * h,
+                coeff(i, 1), 1e-9);
+    ASSERT_NEAR(coeff(i + 1, 2) - 3 * coeff(i + 1, 3) * h, coeff(i, 2),
+                1e-12);
+  }
+  std::vector<double> t{points[5].first + 1, points[200].first - 3}, out;
+  ctrl.GetSmoothingValues(t, out);
+  ASSERT_EQ(out[1], ctrl.GetSmoothingValue(t[1]));
+
+  ctrl.SetAutoSmoothing(false);
+  ctrl.SetSmoothing(1);
+  ASSERT_THROW(ctrl.SetSmoothing(-1), std::invalid_argument);
+  points[10].first = points[9].first;
+  ASSERT_THROW(ctrl.initSmoothingSpline(points), std::invalid_argument);
+}
+
+TEST(model, SmoothingSplineTrace) {
+  // Mean spacing 1, so the dense matrices use the abscissas as they are
+  const size_t n = 12, m = n - 2;
+  std::vector<s21::Point> points;
+  for (size_t i = 0; i < n; ++i) {
+    double x = i + (i > 0 && i + 1 < n ? 0.3 * std::sin(i * 1.7) : 0.0);
+    points.push_back({x, std::cos(i * 0.9) + 0.1 * (i % 3)});
+  }
+  std::vector<double> h(n - 1);
+  for (size_t i = 0; i + 1 < n; ++i) {
+    h[i] = points[i + 1].first - points[i].first;
+  }
+  // n - tr(A) with A = (I + lambda * Q R^-1 Q')^-1
+  std::vector<double> r(m * m, 0), q(n * m, 0);
+  for (size_t j = 0; j < m; ++j) {
+    r[j * m + j] = (h[j] + h[j + 1]) / 3;
+    if (j + 1 < m) r[j * m + j + 1] = r[(j + 1) * m + j] = h[j + 1] / 6;
+    q[j * m + j] = 1 / h[j];
+    q[(j + 1) * m + j] = -1 / h[j] - 1 / h[j + 1];
+    q[(j + 2) * m + j] = 1 / h[j + 1];
+  }
+  s21::LuSolver lu;
+  lu.factorize(r.data(), m);
+  std::vector<double> rq(m * n), column(m);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < m; ++j) column[j] = q[i * m + j];
+    lu.solve(column.data(), column.data());
+    for (size_t j = 0; j < m; ++j) rq[j * n + i] = column[j];
+  }
+  s21::SmoothingSpline spline;
+  for (double lambda : {0.01, 0.7, 25.0}) {
+    std::vector<double> b(n * n, 0), unit(n);
+    for (size_t i = 0; i < n; ++i) {
+      b[i * n + i] = 1;
+      for (size_t k = 0; k < n; ++k) {
+        for (size_t j = 0; j < m; ++j) {
+          b[i * n + k] += lambda * q[i * m + j] * rq[j * n + k];
+        }
+      }
+    }
+    lu.factorize(b.data(), n);
+    double trace = 0;
+    for (size_t i = 0; i < n; ++i) {
+      std::fill(unit.begin(), unit.end(), 0.0);
+      unit[i] = 1;
+      lu.solve(unit.data(), unit.data());
+      trace += unit[i];
+    }
+    spline.setSmoothing(lambda);
+    spline.initSmoothingSpline(points);
+    ASSERT_NEAR(spline.getResidualDof(), n - trace, 1e-10);
+  }
+}
+
+TEST(model, HermiteSpline) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  // A price gap: the cubic spline overshoots both plateaus, PCHIP not
+  std::vector<s21::Point> step{{0, 10}, {1, 10}, {2, 10}, {3, 20},
+                               {4, 20}, {5, 20}, {6, 21}};
+  ctrl.initHermiteSpline(step);
+  ctrl.initCubicSpline(step);
+  double spline_max = 0;
+  for (double t = 0; t <= 6; t += 0.05) {
+    double value = ctrl.GetHermiteValue(t);
+    ASSERT_GE(value, 10 - 1e-12);
+    ASSERT_LE(value, 21 + 1e-12);
+    if (t > 2 && t < 3) {
+      ASSERT_LE(ctrl.GetHermiteValue(t - 0.05), value);
+    }
+    if (t > 3 && t < 5) {
+      ASSERT_DOUBLE_EQ(value, 20);
+    }
+    spline_max = std::max(spline_max, ctrl.GetSplineValue(t) - 20);
+  }
+  ASSERT_GT(spline_max, 0.1);
+  for (auto& it : step) {
+    ASSERT_DOUBLE_EQ(ctrl.GetHermiteValue(it.first), it.second);
+  }
+  ASSERT_THROW(ctrl.GetHermiteValue(6.5), std::invalid_argument);
+
+  std::vector<s21::Point> points;
+  for (int i = 0; i < 40000; ++i) {
+    points.push_back({i * 1.5 + (i % 3) * 0.25, std::sin(i * 0.3) + i % 7});
+  }
+  s21::ThreadPool serial_pool(0), pool(3);
+  s21::HermiteInterpolation serial, parallel, live;
+  serial.setThreadPool(serial_pool);
+  parallel.setThreadPool(pool);
+  serial.initHermiteSpline(points);
+  parallel.initHermiteSpline(points);
+  live.initHermiteSpline(
+      std::vector<s21::Point>(points.begin(), points.begin() + 2));
+  live.appendPoints(std::vector<s21::Point>(points.begin() + 2, points.end()));
+  s21::SplineCoeffView lhs = serial.getCoeff();
+  for (auto* other : {&parallel, &live}) {
+    s21::SplineCoeffView rhs = other->getCoeff();
+    ASSERT_EQ(lhs.rows(), rhs.rows());
+    for (size_t i = 0; i < lhs.rows(); ++i) {
+      for (size_t j = 0; j < lhs.cols(); ++j) {
+        ASSERT_EQ(lhs(i, j), rhs(i, j)) << i << " " << j;
+      }
+    }
+  }
+  std::vector<double> t, out;
+  for (double x = points.front().first; x < points.back().first; x += 7.7) {
+    t.push_back(x);
+  }
+  ctrl.initHermiteSpline(points);
+  ctrl.GetHermiteValues(t, out);
+  for (size_t i = 0; i < t.size(); ++i) {
+    ASSERT_EQ(out[i], serial.getValue(t[i]));
+  }
+}
+
+TEST(model, DerivativesAndIntegrals) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+  auto f = [](double t) { return t * t * t - 2 * t * t + 5; };
+  auto f1 = [](double t) { return 3 * t * t - 4 * t; };
+  auto f2 = [](double t) { return 6 * t - 4; };
+  auto big_f = [](double t) {
+    return t * t * t * t / 4 - 2 * t * t * t / 3 + 5 * t;
+  };
+  std::vector<s21::Point> nodes;
+  for (double t = 10; t <= 14; t += 0.5) {
+    nodes.push_back({t, f(t)});
+  }
+  std::vector<double> t{10.3, 11.75, 13.9}, out;
+  std::vector<double> from{10, 12.2, 13}, to{14, 10.5, 13};
+
+  ctrl.initNewtonPolynomial(nodes);
+  ctrl.SetApproxMethod(s21::ApproxMethod::kQr);
+  ctrl.initApproximation(nodes, 3);
+  for (int order : {1, 2}) {
+    ctrl.GetNewtonDerivatives(t, out, order);
+    for (size_t i = 0; i < t.size(); ++i) {
+      double expected = order == 1 ? f1(t[i]) : f2(t[i]);
+      ASSERT_NEAR(out[i], expected, 1e-7);
+      ASSERT_NEAR(ctrl.GetNewtonDerivative(t[i], order), expected, 1e-7);
+      ASSERT_NEAR(ctrl.GetApproxDerivative(t[i], order), expected, 1e-7);
+    }
+  }
+  ctrl.GetNewtonIntegrals(from, to, out);
+  for (size_t i = 0; i < from.size(); ++i) {
+    double expected = big_f(to[i]) - big_f(from[i]);
+    ASSERT_NEAR(out[i], expected, 1e-7);
+    ASSERT_NEAR(ctrl.GetApproxIntegral(from[i], to[i]), expected, 1e-7);
+  }
+  ctrl.SetApproxMethod(s21::ApproxMethod::kNormalEquations);
+  ctrl.initApproximation(nodes, 2);
+  ctrl.GetApproxDerivatives(t, out, 1);
+  for (size_t i = 0; i < t.size(); ++i) {
+    double h = 1e-4;
+    double left = ctrl.GetApproxValue(t[i] - h);
+    ASSERT_NEAR(out[i], (ctrl.GetApproxValue(t[i] + h) - left) / (2 * h),
+                1e-5);
+  }
+  ctrl.SetInterpolationForm(s21::InterpolationForm::kBarycentric);
+  ASSERT_THROW(ctrl.GetNewtonDerivative(11), std::domain_error);
+  ASSERT_THROW(ctrl.GetNewtonIntegral(10, 11), std::domain_error);
+  ctrl.SetInterpolationForm(s21::InterpolationForm::kNewton);
+
+  // Spline: against finite differences and Simpson's rule of the values
+  std::vector<s21::Point> points;
+  for (int i = 0; i < 300; ++i) {
+    points.push_back({i * 1.5 + (i % 3) * 0.25, std::sin(i * 0.3) + i % 7});
+  }
+  ctrl.initCubicSpline(points);
+  for (double x = 2.13; x < 440; x += 17.3) {
+    double h = 1e-5;
+    ASSERT_NEAR(ctrl.GetSplineDerivative(x),
+                (ctrl.GetSplineValue(x + h) - ctrl.GetSplineValue(x - h)) /
+                    (2 * h),
+                1e-5);
+    ASSERT_NEAR(ctrl.GetSplineDerivative(x, 2),
+                (ctrl.GetSplineDerivative(x + h) -
+                 ctrl.GetSplineDerivative(x - h)) /
+                    (2 * h),
+                1e-5);
+  }
+  auto simpson = [&ctrl](double a, double b) {
+    const int n = 20000;
+    double h = (b - a) / n, sum = 0;
+    for (int i = 0; i <= n; ++i) {
+      sum += (i == 0 || i == n ? 1 : i % 2 ? 4 : 2) *
+             ctrl.GetSplineValue(a + i * h);
+    }
+    return sum * h / 3;
+  };
+  ASSERT_NEAR(ctrl.GetSplineIntegral(3.3, 401.7), simpson(3.3, 401.7), 1e-4);
+  ASSERT_NEAR(ctrl.GetSplineIntegral(50, 20), -simpson(20, 50), 1e-4);
+  ctrl.GetSplineIntegrals({0, 100}, {100, 300}, out);
+  ASSERT_NEAR(out[0] + out[1], ctrl.GetSplineIntegral(0, 300), 1e-9);
+
+  s21::SplineInterpolation full, live;
+  full.initCubicSpline(points);
+  live.initCubicSpline(
+      std::vector<s21::Point>(points.begin(), points.begin() + 150));
+  ASSERT_NEAR(live.getIntegral(1, 200), full.getIntegral(1, 200), 1e-3);
+  live.appendPoints(
+      std::vector<s21::Point>(points.begin() + 150, points.end()));
+  ASSERT_DOUBLE_EQ(live.getIntegral(1, 440), full.getIntegral(1, 440));
+  ASSERT_THROW(live.getIntegral(1, 500), std::invalid_argument);
+  ASSERT_THROW(live.getDerivative(5, 3), std::invalid_argument);
+}
+
+TEST(model, InitFromTimeSeries) {
+  s21::Model series_model;
+  series_model.loadFromFile(kDataSet + "t1.csv");
+  s21::TimeSeries& data = series_model.getData();
+  ASSERT_EQ(data.size(), 4U);
+
+  series_model.initNewtonPolynomial(data);
+  series_model.initCubicSpline(data);
+  for (size_t i = 0; i < data.size(); ++i) {
+    double t = static_cast<double>(data.time[i]);
+    ASSERT_NEAR(series_model.getNewtonValue(t), data.value[i], 1e-9);
+    ASSERT_NEAR(series_model.getSplineValue(t), data.value[i], 1e-9);
+  }
+
+  series_model.initApproximation(data, 1);
+  double mid = 0.5 * (data.time.front() + data.time.back());
+  ASSERT_TRUE(std::isfinite(series_model.getApproxValue(mid)));
+}
+
+TEST(model, SegmentLookup) {
+  auto linear = [](const std::vector<double>& knots, double t) -> size_t {
+    for (size_t i = 1; i < knots.size(); ++i) {
+      if (knots[i - 1] - s21::kEps < t && knots[i] + s21::kEps > t) return i;
+    }
+    return s21::SegmentLookup::kNotFound;
+  };
+  std::vector<std::vector<double>> grids{
+      {0, 1, 2, 3, 4, 5, 6, 7}, {1, 2, 4, 7, 7.5, 20, 21, 100}};
+  for (auto& knots : grids) {
+    s21::SegmentLookup lookup;
+    lookup.init(std::vector<double>(knots));
+    ASSERT_EQ(lookup.isUniform(), knots.size() == 8 && knots[1] == 1);
+    std::vector<double> queries{-1, 101, knots.front() - 2e-6};
+    for (double x : knots) {
+      for (double d : {-2e-6, -5e-7, 0.0, 5e-7, 2e-6, 0.3}) {
+        queries.push_back(x + d);
+      }
+    }
+    for (double t : queries) {
+      ASSERT_EQ(lookup.find(t), linear(knots, t)) << t;
+    }
+    for (auto it = queries.rbegin(); it != queries.rend(); ++it) {
+      ASSERT_EQ(lookup.find(*it), linear(knots, *it)) << *it;
+    }
+  }
+}
+
 TEST(model, GetApproxCoeff_1) {
   s21::Controller& ctrl = s21::Controller::GetInstance();
   ctrl.Connect(&model);
@@ -137,6 +817,515 @@ TEST(model, GetApproxCoeff_1) {
   }
 }
 
+TEST(model, LuSolver) {
+  s21::Matrix matrix{{0, 2, 1, 5}, {1, 1, 1, 4}, {2, 1, 3, 7}};
+  s21::Gauss gauss;
+  std::vector<double> sample{1, 2, 1};
+  auto& result = gauss.getResultSLAE(matrix);
+  ASSERT_EQ(result.size(), sample.size());
+  for (size_t i = 0; i < sample.size(); ++i) {
+    ASSERT_NEAR(result[i], sample[i], 1e-12);
+  }
+
+  std::vector<double> b{-1, 2, 3};
+  gauss.getSolver().solve(b);
+  std::vector<double> sample_b{3, 0, -1};
+  for (size_t i = 0; i < sample_b.size(); ++i) {
+    ASSERT_NEAR(b[i], sample_b[i], 1e-12);
+  }
+
+  s21::LuSolver lu;
+  lu.factorize({4, 3, 6, 3}, 2);
+  std::vector<double> x{10, 12};
+  lu.solve(x);
+  ASSERT_NEAR(x[0], 1, 1e-12);
+  ASSERT_NEAR(x[1], 2, 1e-12);
+
+  matrix = {{1, 2, 3}, {2, 4, 6}};
+  ASSERT_THROW(gauss.getResultSLAE(matrix), std::invalid_argument);
+}
+
+TEST(model, BlockedLu) {
+  const size_t n = 75;
+  std::vector<double> a(n * n), x(n), b(n, 0);
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (auto& it : a) it = dist(gen);
+  for (auto& it : x) it = dist(gen);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) b[i] += a[i * n + j] * x[j];
+  }
+
+  s21::LuSolver plain, blocked, parallel;
+  s21::ThreadPool pool(3);
+  plain.factorize(std::vector<double>(a), n);
+  blocked.setBlockSize(8);
+  blocked.factorize(std::vector<double>(a), n);
+  parallel.setBlockSize(8);
+  parallel.setThreadPool(&pool);
+  parallel.factorize(std::vector<double>(a), n);
+  ASSERT_EQ(blocked.getPivot(), plain.getPivot());
+  ASSERT_EQ(parallel.getData(), blocked.getData());
+  for (size_t i = 0; i < n * n; ++i) {
+    ASSERT_NEAR(blocked.getData()[i], plain.getData()[i], 1e-9);
+  }
+  std::vector<double> result(n);
+  blocked.solve(b.data(), result.data());
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_NEAR(result[i], x[i], 1e-9);
+  }
+
+  s21::Gauss gauss;
+  gauss.setMode(s21::SlaeMode::kBlockedLu);
+  gauss.setThreadPool(pool);
+  gauss.loadFromFile(kDataSet + "slae_5.txt");
+  auto& parallel_result = gauss.getResultWithParallelAlgo();
+  for (size_t i = 0; i < parallel_result.size(); ++i) {
+    ASSERT_NEAR(parallel_result[i], i + 1, 1e-12);
+  }
+}
+
+TEST(model, SolveBatch) {
+  const size_t n = 5, count = 11;
+  std::vector<double> a(count * n * n), b(count * n), x(count * n);
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (auto& it : a) it = dist(gen);
+  for (auto& it : b) it = dist(gen);
+  std::fill(a.begin() + 3 * n * n, a.begin() + 3 * n * n + n, 0.0);
+  ASSERT_EQ(s21::solveBatch(a.data(), b.data(), x.data(), n, count), 1);
+  for (size_t s = 0; s < count; ++s) {
+    s21::LuSolver lu;
+    lu.factorize(std::vector<double>(a.begin() + s * n * n,
+                                     a.begin() + (s + 1) * n * n),
+                 n);
+    std::vector<double> sample(b.begin() + s * n, b.begin() + (s + 1) * n);
+    for (size_t i = 0; i < n; ++i) {
+      if (s == 3) {
+        ASSERT_TRUE(std::isnan(x[s * n + i]));
+        continue;
+      }
+      if (i == 0) lu.solve(sample);
+      ASSERT_NEAR(x[s * n + i], sample[i], 1e-9);
+    }
+  }
+
+  // Above kBatchMaxSize: one system at a time, refined all the same
+  const size_t big = s21::kBatchMaxSize + 3;
+  std::vector<double> big_a(3 * big * big), big_b(3 * big), big_x(3 * big);
+  for (auto& it : big_a) it = dist(gen);
+  for (auto& it : big_b) it = dist(gen);
+  std::fill(big_a.begin() + big * big, big_a.begin() + 2 * big * big, 0.0);
+  ASSERT_EQ(s21::solveBatch(big_a.data(), big_b.data(), big_x.data(), big, 3),
+            1);
+  ASSERT_TRUE(std::isnan(big_x[big]));
+  for (size_t s : {0, 2}) {
+    for (size_t i = 0; i < big; ++i) {
+      double sum = 0;
+      for (size_t j = 0; j < big; ++j) {
+        sum += big_a[(s * big + i) * big + j] * big_x[s * big + j];
+      }
+      ASSERT_NEAR(sum, big_b[s * big + i], 1e-12);
+    }
+  }
+
+  std::vector<std::vector<s21::Point>> series{
+      {{0, 4}, {1, 1}, {2, 0}, {3, 1}, {4, 4}}, {}, {{0, 1}, {1, 3}, {2, 5}}};
+  auto coeffs = s21::Approximation::fitBatch(series, 2);
+  ASSERT_EQ(coeffs.size(), 3);
+  ASSERT_TRUE(coeffs[1].empty());
+  std::vector<double> parabola{4, -4, 1}, line{1, 2, 0};
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_NEAR(coeffs[0][i], parabola[i], 1e-9);
+    ASSERT_NEAR(coeffs[2][i], line[i], 1e-9);
+  }
+}
+
+TEST(model, ApproximationQr) {
+  s21::Approximation approx;
+  approx.setMethod(s21::ApproxMethod::kQr);
+  std::vector<s21::Point> points{{0, 4}, {1, 1}, {2, 0}, {3, 1}, {4, 4}};
+  approx.initApproximation(points, 2);
+  ASSERT_NEAR(approx.getShift(), 2, 1e-12);
+  ASSERT_NEAR(approx.getScale(), 0.5, 1e-12);
+  for (auto& it : points) {
+    ASSERT_NEAR(approx.getValue(it.first), it.second, 1e-12);
+  }
+
+  // Degree 20 over epoch seconds, more rows than one chunk
+  s21::TimeSeries data;
+  const size_t count = 2000;
+  const std::int64_t start = 1600000000;
+  for (size_t i = 0; i < count; ++i) {
+    data.push_back(start + i * s21::kSecInDay, std::sin(2.0 * i / count));
+  }
+  approx.initApproximation(data, 20);
+  ASSERT_EQ(approx.getCoeff().size(), 21);
+  for (size_t i = 0; i < count; i += 7) {
+    ASSERT_NEAR(approx.getValue(data.time[i]), data.value[i], 1e-9);
+  }
+
+  approx.initApproximation(std::vector<s21::Point>{{1, 1}, {2, 2}}, 3);
+  ASSERT_TRUE(approx.getCoeff().empty());
+}
+
+TEST(model, ApproximationOrthogonal) {
+  s21::Approximation approx;
+  approx.setMethod(s21::ApproxMethod::kOrthogonal);
+  std::vector<s21::Point> points{{0, 4}, {1, 1}, {2, 0}, {3, 1}, {4, 4}};
+  approx.initApproximation(points, 4);
+  ASSERT_EQ(approx.getResiduals().size(), 5);
+  ASSERT_NEAR(approx.getResiduals()[2], 0, 1e-9);
+  for (auto& it : points) {
+    ASSERT_NEAR(approx.getValue(it.first), it.second, 1e-9);
+  }
+  ASSERT_TRUE(approx.selectDegree(1));
+  for (auto& it : points) {
+    ASSERT_NEAR(approx.getValue(it.first), 2, 1e-12);
+  }
+  ASSERT_FALSE(approx.selectDegree(5));
+
+  // Every degree of the sweep against an independent QR fit
+  s21::TimeSeries data;
+  const size_t count = 1500;
+  for (size_t i = 0; i < count; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay,
+                   std::sin(3.0 * i / count) + std::cos(7.0 * i / count));
+  }
+  approx.initApproximation(data, 20);
+  s21::Approximation qr;
+  qr.setMethod(s21::ApproxMethod::kQr);
+  std::vector<double> t(data.time.begin(), data.time.end()), out(count);
+  for (int degree = 20; degree >= 1; --degree) {
+    ASSERT_TRUE(approx.selectDegree(degree));
+    qr.initApproximation(data, degree);
+    ASSERT_EQ(approx.getCoeff().size(), qr.getCoeff().size());
+    for (size_t i = 0; i < approx.getCoeff().size(); ++i) {
+      ASSERT_NEAR(approx.getCoeff()[i], qr.getCoeff()[i],
+                  1e-6 * (1 + std::fabs(qr.getCoeff()[i])));
+    }
+    approx.evaluate(t.data(), out.data(), count);
+    for (size_t i = 0; i < count; i += 11) {
+      ASSERT_NEAR(out[i], qr.getValue(t[i]), 1e-9);
+      ASSERT_DOUBLE_EQ(out[i], approx.getValue(t[i]));
+    }
+  }
+
+  approx.initApproximation(std::vector<s21::Point>{{1, 1}, {1, 2}}, 1);
+  ASSERT_TRUE(approx.getCoeff().empty());
+}
+
+TEST(model, ApproximationAccumulator) {
+  std::vector<s21::Point> points{{0, 4}, {1, 1}, {2, 0}, {3, 1}, {4, 4}};
+  s21::ApproximationAccumulator acc(2);
+  acc.add(points);
+  auto coeff = acc.getCoeff();
+  std::vector<double> parabola{4, -4, 1};
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_NEAR(coeff[i], parabola[i], 1e-9);
+  }
+  ASSERT_NEAR(acc.getValue(2, 1), 2, 1e-9);
+
+  // Sliding window over daily quotes against a refit of the window
+  s21::TimeSeries data;
+  const size_t count = 300, window = 60;
+  for (size_t i = 0; i < count; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay,
+                   100 + std::sin(0.05 * i) + 0.001 * i * i);
+  }
+  s21::ApproximationAccumulator sliding(3, data.time.front(),
+                                        1.0 / s21::kSecInDay);
+  s21::Approximation approx;
+  approx.setMethod(s21::ApproxMethod::kQr);
+  for (size_t i = 0; i < count; ++i) {
+    sliding.add(data.time[i], data.value[i]);
+    if (i < window) continue;
+    sliding.remove(data.time[i - window], data.value[i - window]);
+    if (i % 50 != 49) continue;
+    ASSERT_EQ(sliding.size(), window);
+    s21::TimeSeries part;
+    for (size_t j = i + 1 - window; j <= i; ++j) {
+      part.push_back(data.time[j], data.value[j]);
+    }
+    approx.initApproximation(part, 3);
+    ASSERT_NEAR(sliding.getValue(data.time[i]), approx.getValue(data.time[i]),
+                1e-6);
+  }
+
+  // Halves with their own origins merged equal one pass over all
+  s21::ApproximationAccumulator whole(3, data.time.front(),
+                                     1.0 / s21::kSecInDay);
+  s21::ApproximationAccumulator first(3, data.time.front(),
+                                      1.0 / s21::kSecInDay);
+  s21::ApproximationAccumulator second(3, data.time[count / 2],
+                                       0.5 / s21::kSecInDay);
+  whole.add(data);
+  for (size_t i = 0; i < count; ++i) {
+    (i < count / 2 ? first : second).add(data.time[i], data.value[i]);
+  }
+  first.merge(second);
+  ASSERT_EQ(first.size(), count);
+  auto merged = first.getCoeff(), sample = whole.getCoeff();
+  for (size_t i = 0; i < sample.size(); ++i) {
+    ASSERT_NEAR(merged[i], sample[i], 1e-6 * (1 + std::fabs(sample[i])));
+  }
+  ASSERT_THROW(first.merge(s21::ApproximationAccumulator(2)),
+               std::invalid_argument);
+  ASSERT_TRUE(s21::ApproximationAccumulator(4).getCoeff().empty());
+}
+
+TEST(model, RollingRegression) {
+  s21::TimeSeries data;
+  const size_t count = 400, window = 30, horizon = 5;
+  for (size_t i = 0; i < count; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay + (i % 3) * 3600,
+                   100 + 5 * std::sin(0.03 * i) + 0.01 * (i % 7));
+  }
+  s21::RollingRegression rolling(2, window, horizon);
+  std::vector<double> serial, parallel;
+  rolling.forecast(data, serial);
+  ASSERT_EQ(serial.size(), count - window - horizon);
+
+  s21::ThreadPool pool(3);
+  rolling.setThreadPool(&pool);
+  rolling.forecast(data, parallel);
+  ASSERT_EQ(parallel.size(), serial.size());
+
+  s21::Approximation approx;
+  approx.setMethod(s21::ApproxMethod::kQr);
+  for (size_t i = 0; i < serial.size(); ++i) {
+    ASSERT_NEAR(parallel[i], serial[i], 1e-9);
+    if (i % 37) continue;
+    s21::TimeSeries part;
+    for (size_t j = i; j < i + window; ++j) {
+      part.push_back(data.time[j], data.value[j]);
+    }
+    approx.initApproximation(part, 2);
+    ASSERT_NEAR(serial[i],
+                approx.getValue(data.time[i + window + horizon]), 1e-8);
+  }
+
+  s21::TimeSeries few;
+  few.push_back(0, 1);
+  rolling.forecast(few, serial);
+  ASSERT_TRUE(serial.empty());
+  ASSERT_THROW(s21::RollingRegression(3, 3), std::invalid_argument);
+}
+
+TEST(model, ApproximationSums) {
+  std::vector<s21::Point> points(100000);
+  std::mt19937 gen(4);
+  std::uniform_real_distribution<double> noise(-0.1, 0.1);
+  for (size_t i = 0; i < points.size(); ++i) {
+    double x = 2.0 * i / points.size();
+    points[i] = {x, std::sin(3 * x) + noise(gen)};
+  }
+  s21::ThreadPool single(0), several(3);
+  s21::Approximation first, second;
+  first.setThreadPool(single);
+  second.setThreadPool(several);
+  first.initApproximation(points, 6);
+  second.initApproximation(points, 6);
+  ASSERT_EQ(first.getCoeff(), second.getCoeff());
+
+  s21::Approximation qr;
+  qr.setMethod(s21::ApproxMethod::kQr);
+  qr.initApproximation(points, 6);
+  for (size_t i = 0; i < points.size(); i += 997) {
+    ASSERT_NEAR(first.getValue(points[i].first),
+                qr.getValue(points[i].first), 1e-8);
+  }
+}
+
+TEST(model, WeightedApproximation) {
+  // Weight 2 on a point is the same as the point taken twice
+  std::vector<s21::Point> points{{0, 1}, {1, 3}, {2, 2}, {3, 5}, {4, 4}};
+  std::vector<double> weights{1, 2, 1, 2, 1};
+  std::vector<s21::Point> twice;
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (int k = 0; k < weights[i]; ++k) twice.push_back(points[i]);
+  }
+  for (auto method :
+       {s21::ApproxMethod::kNormalEquations, s21::ApproxMethod::kQr,
+        s21::ApproxMethod::kOrthogonal}) {
+    s21::Approximation weighted, repeated;
+    weighted.setMethod(method);
+    repeated.setMethod(method);
+    weighted.initApproximation(points, weights, 2);
+    repeated.initApproximation(twice, 2);
+    for (double t = 0; t <= 4; t += 0.5) {
+      ASSERT_NEAR(weighted.getValue(t), repeated.getValue(t), 1e-9);
+    }
+  }
+  s21::Approximation approx;
+  ASSERT_THROW(approx.initApproximation(points, {1, 2}, 1),
+               std::invalid_argument);
+
+  // A half-life is the matching explicit decay
+  s21::TimeSeries data;
+  for (size_t i = 0; i < 200; ++i) {
+    data.push_back(1600000000 + i * s21::kSecInDay,
+                   100 + std::sin(0.05 * i) + 0.01 * i);
+  }
+  const double half_life = 30.0 * s21::kSecInDay;
+  std::vector<double> decay(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    decay[i] = std::exp2((data.time[i] - data.time.back()) / half_life);
+  }
+  s21::Approximation explicit_decay;
+  explicit_decay.initApproximation(data, decay, 3);
+  approx.setHalfLife(half_life);
+  approx.initApproximation(data, 3);
+  for (size_t i = 0; i < data.size(); i += 13) {
+    ASSERT_NEAR(approx.getValue(data.time[i]),
+                explicit_decay.getValue(data.time[i]), 1e-9);
+  }
+
+  // The accumulator decays point by point, merged halves included
+  s21::ApproximationAccumulator acc(3, data.time.front(),
+                                    1.0 / s21::kSecInDay);
+  s21::ApproximationAccumulator first(3, data.time.front(),
+                                      1.0 / s21::kSecInDay);
+  s21::ApproximationAccumulator second(3, data.time.back(),
+                                       1.0 / s21::kSecInDay);
+  acc.setHalfLife(half_life);
+  first.setHalfLife(half_life);
+  second.setHalfLife(half_life);
+  for (size_t i = 0; i < data.size(); ++i) {
+    acc.add(data.time[i], data.value[i]);
+    (i % 2 ? first : second).add(data.time[i], data.value[i]);
+  }
+  second.merge(first);
+  for (size_t i = 0; i < data.size(); i += 13) {
+    ASSERT_NEAR(acc.getValue(data.time[i]), approx.getValue(data.time[i]),
+                1e-7);
+    ASSERT_NEAR(second.getValue(data.time[i]), acc.getValue(data.time[i]),
+                1e-7);
+  }
+  ASSERT_THROW(acc.setHalfLife(1), std::logic_error);
+
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+  ctrl.SetApproxHalfLife(0);
+  ctrl.initApproximation(points, weights, 2);
+  s21::Approximation repeated;
+  repeated.initApproximation(twice, 2);
+  for (auto& it : points) {
+    ASSERT_NEAR(ctrl.GetApproxValue(it.first), repeated.getValue(it.first),
+                1e-9);
+  }
+}
+
+TEST(model, AutoDegree) {
+  // Cubic trend plus noise: leave-one-out picks 3 out of 0..12
+  std::vector<s21::Point> points;
+  std::mt19937 gen(6);
+  std::normal_distribution<double> noise(0, 0.05);
+  for (int i = 0; i < 120; ++i) {
+    double x = i / 60.0 - 1;
+    points.push_back({x, 1 + x - 2 * x * x + 1.5 * x * x * x + noise(gen)});
+  }
+  s21::Approximation approx;
+  approx.setAutoDegree(true);
+  approx.initApproximation(points, 12);
+  ASSERT_EQ(approx.getScores().size(), 13);
+  ASSERT_EQ(approx.getDegree(), 3);
+  auto& scores = approx.getScores();
+  ASSERT_EQ(std::min_element(scores.begin(), scores.end()) - scores.begin(),
+            3);
+
+  // Scores against explicit leave-one-out refits
+  for (int degree : {1, 3, 6}) {
+    double press = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+      std::vector<s21::Point> rest(points);
+      rest.erase(rest.begin() + i);
+      s21::Approximation refit;
+      refit.setMethod(s21::ApproxMethod::kQr);
+      refit.initApproximation(rest, degree);
+      double r = points[i].second - refit.getValue(points[i].first);
+      press += r * r;
+    }
+    ASSERT_NEAR(scores[degree], press / points.size(),
+                1e-6 * press / points.size());
+  }
+
+  // Fewer distinct points than the highest degree: search stops early
+  approx.initApproximation({{0, 1}, {1, 2}, {2, 2.5}}, 5);
+  ASSERT_EQ(approx.getScores().size(), 3);
+  ASSERT_FALSE(approx.getCoeff().empty());
+
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+  ctrl.SetApproxAutoDegree(true);
+  ctrl.initApproximation(points, 12);
+  ASSERT_EQ(ctrl.GetApproxDegree(), 3);
+  ASSERT_EQ(ctrl.GetApproxScores().size(), 13);
+  ctrl.SetApproxAutoDegree(false);
+}
+
+TEST(model, ThreadPool) {
+  s21::ThreadPool pool(3);
+  ASSERT_EQ(pool.size(), 4);
+  std::vector<int> hits(10000);
+  pool.parallelFor(0, hits.size(), 64, [&hits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) ++hits[i];
+  });
+  ASSERT_EQ(std::count(hits.begin(), hits.end(), 1), 10000);
+
+  std::atomic<size_t> sum{0};
+  pool.parallelFor(0, 8, 1, [&pool, &sum](size_t begin, size_t) {
+    pool.parallelFor(0, 100, 10, [&sum, begin](size_t first, size_t last) {
+      for (size_t i = first; i < last; ++i) sum += begin * 100 + i;
+    });
+  });
+  ASSERT_EQ(sum.load(), 799 * 800 / 2);
+
+  s21::Gauss gauss;
+  gauss.setThreadPool(pool);
+  gauss.loadFromFile(kDataSet + "slae_5.txt");
+  std::vector<double> serial = gauss.getResultWithoutParallelAlgo();
+  std::vector<double> parallel = gauss.getResultWithParallelAlgo();
+  ASSERT_EQ(serial, parallel);
+  for (size_t i = 0; i < parallel.size(); ++i) {
+    ASSERT_NEAR(parallel[i], i + 1, 1e-12);
+  }
+}
+
+TEST(model, EvaluateBatch) {
+  s21::Controller& ctrl = s21::Controller::GetInstance();
+  ctrl.Connect(&model);
+
+  std::vector<s21::Point> points{{1, 2}, {2, 3}, {4, 1}, {7, 4}, {8, 6}};
+  std::vector<double> t, out;
+  for (int i = 0; i <= 140; ++i) {
+    t.push_back(1.0 + 0.05 * i);
+  }
+
+  ctrl.initNewtonPolynomial(points);
+  ctrl.GetNewtonValues(t, out);
+  ASSERT_EQ(out.size(), t.size());
+  for (size_t i = 0; i < t.size(); ++i) {
+    ASSERT_NEAR(out[i], ctrl.GetNewtonValue(t[i]), 1e-9);
+  }
+
+  ctrl.initCubicSpline(points);
+  ctrl.GetSplineValues(t, out);
+  for (size_t i = 0; i < t.size(); ++i) {
+    ASSERT_DOUBLE_EQ(out[i], ctrl.GetSplineValue(t[i]));
+  }
+
+  ctrl.initApproximation(points, 3);
+  ctrl.GetApproxValues(t, out);
+  for (size_t i = 0; i < t.size(); ++i) {
+    ASSERT_NEAR(out[i], ctrl.GetApproxValue(t[i]), 1e-9);
+  }
+
+  t.push_back(9.0);
+  ctrl.initCubicSpline(points);
+  ASSERT_THROW(ctrl.GetSplineValues(t, out), std::invalid_argument);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
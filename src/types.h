@@ -1,7 +1,12 @@
 #ifndef SRC_TYPES_H_
 #define SRC_TYPES_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace s21 {
 
@@ -11,11 +16,41 @@ constexpr int kSecInDay = 86400;
 constexpr double kPadCoeff = 0.05;
 constexpr int kMaxCountGraph = 5;
 constexpr double kEps = 1e-6;
+// Batch evaluation works on fixed-size blocks the compiler can vectorize
+constexpr size_t kEvalBlock = 64;
+
+enum class LoadMode { kStream, kMapped };
+enum class InterpolationForm { kNewton, kBarycentric };
+// Least squares backend: normal equations over the raw time, Householder
+// QR of the Vandermonde matrix over scaled time, or polynomials orthogonal
+// over the points (every degree up to the requested one in one pass)
+enum class ApproxMethod { kNormalEquations, kQr, kOrthogonal };
 
-using DataPoint = std::pair<std::tm, double>;
 using Point = std::pair<double, double>;
 using Matrix = std::vector<std::vector<double>>;
 
+// Quotes as struct of arrays: epoch seconds (local midnight, as mktime()
+// gives for the parsed date) and close prices, converted once at load time
+struct TimeSeries {
+  std::vector<std::int64_t> time;
+  std::vector<double> value;
+
+  auto size() const -> size_t { return time.size(); }
+  auto empty() const -> bool { return time.empty(); }
+  auto reserve(size_t count) -> void {
+    time.reserve(count);
+    value.reserve(count);
+  }
+  auto push_back(std::int64_t t, double v) -> void {
+    time.push_back(t);
+    value.push_back(v);
+  }
+  auto clear() -> void {
+    time.clear();
+    value.clear();
+  }
+};
+
 }  //  namespace s21
 
 #endif  //  SRC_TYPES_H_